@@ -0,0 +1,921 @@
+#include    <stdbool.h>
+#include    <stdint.h>
+#include    <stddef.h>
+#include    "button_bank.h"
+
+static void bank_sweep(button_bank_t* bank, uint32_t current_tick);
+static void bank_sample(button_bank_t* bank, const button_profile_t* profiles, uint16_t index, uint32_t current_tick);
+static void bank_restart(button_bank_t* bank, uint32_t current_tick);
+static uint32_t bank_due_groups(button_bank_t* bank, uint32_t current_tick);
+static void bank_shift_timers(button_bank_t* bank, uint32_t delta);
+static unsigned int lowest_bit(uint32_t word);
+static void bank_step(button_bank_t* bank, const button_profile_t* profiles, uint16_t index, bool is_pressed, uint32_t current_tick);
+static void bank_dispatch(button_bank_t* bank, uint16_t index, button_event_t event);
+static void bank_dispatch_stage(button_bank_t* bank, uint16_t index, button_event_t event, uint8_t stage, uint32_t threshold);
+static void bank_mark_dirty(button_bank_t* bank, uint16_t index);
+static void bank_latency_edge(button_bank_t* bank, uint16_t index, uint32_t current_tick);
+static void bank_latency_event(button_bank_t* bank, uint16_t index, uint32_t current_tick);
+static void bank_latency_settled(button_bank_t* bank, uint16_t index);
+static void bank_monitor_open(button_bank_t* bank);
+static void bank_monitor_close(button_bank_t* bank, uint32_t current_tick);
+static void bank_monitor_state(button_bank_t* bank, uint16_t index);
+static void bank_monitor_event(button_bank_t* bank, uint16_t index, button_event_t event);
+static bool validate_profile(const button_profile_t* profile);
+#if BUTTON_FEATURE_DISPATCH && BUTTON_FEATURE_STAGES
+static void publish_handler(button_bank_t* bank, button_bank_callback_fn callback, button_bank_stage_callback_fn stage_callback, void* context);
+#elif BUTTON_FEATURE_DISPATCH
+static void publish_handler(button_bank_t* bank, button_bank_callback_fn callback, void* context);
+#endif
+
+
+button_error_t Button_BankInit(button_bank_t* bank, const button_bank_entry_t* entries, button_bank_state_t* states, uint16_t count,
+                               const button_profile_t* profiles, uint8_t profile_count,
+                               button_read_gpio_fn read_fn, get_tick_fn tick_fn) {
+
+    if (!bank || !entries || !states || count == 0 || !read_fn || !tick_fn) return BUTTON_ERR_INVALID_ARG;
+    if (!profiles || profile_count == 0) return BUTTON_ERR_INVALID_ARG;
+
+    /* Profiles are shared: validate each one once instead of once per button */
+    for (uint8_t p = 0; p < profile_count; p++) {
+        if (!validate_profile(&profiles[p])) return BUTTON_ERR_INVALID_STAGES;
+    }
+
+    uint32_t now = tick_fn();
+
+    for (uint16_t i = 0; i < count; i++) {
+        if (entries[i].active_level >= BUTTON_ACTIVE_MAX || entries[i].profile >= profile_count) return BUTTON_ERR_INVALID_ARG;
+        states[i] = (button_bank_state_t){
+            .last_change_tick = now,
+            .press_start_tick = now,
+            .last_hold_tick = now,
+            .latches = 0,
+            .state = STATE_IDLE,
+            .profile = entries[i].profile,
+            .hold_stage = 0,
+        };
+    }
+
+    *bank = (button_bank_t){
+        .entries = entries,
+        .states = states,
+        .profiles = profiles,
+        .count = count,
+        .profile_count = profile_count,
+        .sweep_seq = 0,
+        .enabled = NULL,
+        .restart = NULL,
+        .suspended = false,
+        .paused = false,
+        .pause_tick = now,
+        .groups = NULL,
+        .group_members = NULL,
+        .group_count = 0,
+#if BUTTON_FEATURE_DISPATCH
+        .keymap = NULL,
+        .action_func = NULL,
+        .action_context = NULL,
+#endif
+        .dirty = NULL,
+        .latency = NULL,
+        .monitor = NULL,
+        .monitor_open = false,
+        .sweep_tick = now,
+        .sweep_events = 0,
+        .sweep_event_count = 0,
+        .read_pin_func = read_fn,
+        .get_tick_func = tick_fn,
+#if BUTTON_FEATURE_DISPATCH
+        .handler_seq = 0,
+#endif
+    };
+    return BUTTON_OK;
+}
+
+/*
+ * Converts @p count millisecond profiles for a @p tick_hz tick. Stage tables
+ * are converted into @p stage_buf, which must hold every stage of every
+ * profile. Fails with BUTTON_ERR_INVALID_STAGES if rounding merges two stage
+ * thresholds at a coarse tick. The result is what Button_BankInit or
+ * Button_BankPublishProfiles expect; the sweep never divides.
+ */
+button_error_t Button_BankProfilesFromMs(button_profile_t* profiles, button_stage_config_t* stage_buf, uint16_t stage_buf_len,
+                                         const button_profile_ms_t* ms_profiles, uint8_t count, uint32_t tick_hz) {
+    if (!profiles || !ms_profiles || count == 0 || tick_hz == 0) return BUTTON_ERR_INVALID_ARG;
+
+    uint16_t used = 0;
+    for (uint8_t p = 0; p < count; p++) {
+        const button_profile_ms_t *ms = &ms_profiles[p];
+        if (ms->stage_count > 0 && (!ms->stages || !stage_buf || stage_buf_len - used < ms->stage_count)) return BUTTON_ERR_INVALID_ARG;
+
+        for (uint8_t i = 0; i < ms->stage_count; i++) {
+            stage_buf[used + i].threshold = BUTTON_MS_TO_TICKS(ms->stages[i].threshold, tick_hz);
+            stage_buf[used + i].event = ms->stages[i].event;
+            stage_buf[used + i].hold_ticks = (ms->stages[i].hold_ticks == 0 || ms->stages[i].hold_ticks == BUTTON_HOLD_OFF) ?
+                                             ms->stages[i].hold_ticks : BUTTON_MS_TO_TICKS(ms->stages[i].hold_ticks, tick_hz);
+        }
+        profiles[p] = (button_profile_t){
+            .debounce_ticks = BUTTON_MS_TO_TICKS(ms->debounce_ms, tick_hz),
+            .long_press_ticks = BUTTON_MS_TO_TICKS(ms->long_press_ms, tick_hz),
+            .hold_ticks = BUTTON_MS_TO_TICKS(ms->hold_ms, tick_hz),
+            .stages = (ms->stage_count > 0) ? &stage_buf[used] : NULL,
+            .stage_count = ms->stage_count,
+        };
+        used = (uint16_t)(used + ms->stage_count);
+        if (!validate_profile(&profiles[p])) return BUTTON_ERR_INVALID_STAGES;
+    }
+    return BUTTON_OK;
+}
+
+button_error_t Button_BankUpdate(button_bank_t* bank) {
+    return Button_BankUpdateEx(bank, NULL, NULL);
+}
+
+/* Sweep that reports the set (@p events) and number (@p count) of events it dispatched; both optional */
+button_error_t Button_BankUpdateEx(button_bank_t* bank, button_event_mask_t* events, uint32_t* count) {
+    if (!bank || !bank->states || !bank->read_pin_func || !bank->get_tick_func) return BUTTON_ERR_NOT_INIT;
+
+    atomic_fetch_add(&bank->sweep_seq, 1);
+    bank->sweep_events = 0;
+    bank->sweep_event_count = 0;
+
+    uint32_t current_tick = bank->get_tick_func();
+    bank->sweep_tick = current_tick;
+
+    if (atomic_load_explicit(&bank->suspended, memory_order_acquire)) {
+        if (!bank->paused) {
+            bank->paused = true;
+            bank->pause_tick = current_tick;
+        }
+    } else {
+        if (bank->paused) {
+            bank->paused = false;
+            bank_shift_timers(bank, current_tick - bank->pause_tick);
+        }
+        bank_sweep(bank, current_tick);
+    }
+
+    if (bank->monitor) bank_monitor_close(bank, current_tick);
+    atomic_fetch_add(&bank->sweep_seq, 1);
+    if (events) *events = bank->sweep_events;
+    if (count) *count = bank->sweep_event_count;
+    return BUTTON_OK;
+}
+
+/*
+ * One tick read and one profile table per sweep: every button sees the same
+ * snapshot. The load is seq_cst, like the odd sweep_seq store before it and
+ * the publisher's store and sweep_seq read: with weaker orders both sides may
+ * read the old value, and a grace taken before this sweep would free a table
+ * it still uses.
+ */
+static void bank_sweep(button_bank_t* bank, uint32_t current_tick) {
+    const button_profile_t *profiles = atomic_load(&bank->profiles);
+
+    if (!bank->enabled && !bank->groups) {
+        for (uint16_t i = 0; i < bank->count; i++) {
+            bank_sample(bank, profiles, i, current_tick);
+        }
+        return;
+    }
+
+    if (bank->enabled) {
+        bank_restart(bank, current_tick);
+    }
+
+    uint32_t due = bank->groups ? bank_due_groups(bank, current_tick) : 0;
+    if (bank->groups && due == 0) return;
+
+    uint16_t words = (uint16_t)BUTTON_BANK_MASK_WORDS(bank->count);
+    for (uint16_t w = 0; w < words; w++) {
+        uint32_t word = 0xFFFFFFFFu;
+        if (bank->groups) {
+            word = 0;
+            for (uint8_t g = 0; g < bank->group_count; g++) {
+                if (due & (1u << g)) word |= bank->group_members[g * words + w];
+            }
+        }
+        if (bank->enabled) {
+            word &= (uint32_t)atomic_load_explicit(&bank->enabled[w], memory_order_acquire);
+        }
+        while (word) {
+            unsigned int bit = lowest_bit(word);
+            word &= word - 1u;
+            uint16_t i = (uint16_t)(w * 32u + bit);
+            if (i >= bank->count) break;
+            bank_sample(bank, profiles, i, current_tick);
+        }
+    }
+}
+
+static void bank_sample(button_bank_t* bank, const button_profile_t* profiles, uint16_t index, uint32_t current_tick) {
+    const button_bank_entry_t *entry = &bank->entries[index];
+    bool pin_state = (bool)bank->read_pin_func(entry->gpio_num);
+    bool is_pressed = (entry->active_level == BUTTON_ACTIVE_LOW) ? !pin_state : pin_state;
+    bank_step(bank, profiles, index, is_pressed, current_tick);
+    if (bank->monitor) bank_monitor_state(bank, index);
+}
+
+/*
+ * Disabled and re-enabled buttons are parked in IDLE: a disabled one is no
+ * longer sampled and a re-enabled one went stale. A press already reported
+ * gets its RELEASED first, so handlers never see PRESSED without one.
+ */
+static void bank_restart(button_bank_t* bank, uint32_t current_tick) {
+    for (uint16_t w = 0; w < BUTTON_BANK_MASK_WORDS(bank->count); w++) {
+        if (atomic_load_explicit(&bank->restart[w], memory_order_relaxed) == 0) continue;
+        uint32_t word = (uint32_t)atomic_exchange(&bank->restart[w], 0);
+        while (word) {
+            uint16_t i = (uint16_t)(w * 32u + lowest_bit(word));
+            word &= word - 1u;
+            if (i >= bank->count) break;
+            button_bank_state_t *st = &bank->states[i];
+            if (bank->latency) atomic_store_explicit(&bank->latency[i].edge_valid, false, memory_order_relaxed);
+            if (st->state == STATE_PRESSED || st->state == STATE_LONG_PRESSED) {
+                st->state = STATE_IDLE;
+                bank_dispatch(bank, i, BUTTON_EVENT_RELEASED);
+            }
+            st->last_change_tick = current_tick;
+            st->press_start_tick = current_tick;
+            st->last_hold_tick = current_tick;
+            st->latches = 0;
+            st->state = STATE_IDLE;
+            bank_mark_dirty(bank, i);
+            if (bank->monitor) bank_monitor_state(bank, i);
+        }
+    }
+}
+
+/* Bit g set when group g is due; a group that fell behind restarts its period from now */
+static uint32_t bank_due_groups(button_bank_t* bank, uint32_t current_tick) {
+    uint32_t due = 0;
+
+    for (uint8_t g = 0; g < bank->group_count; g++) {
+        if ((int32_t)(current_tick - bank->group_due[g]) < 0) continue;
+        due |= 1u << g;
+        bank->group_due[g] += bank->groups[g].period_ticks;
+        if ((int32_t)(current_tick - bank->group_due[g]) >= 0) {
+            bank->group_due[g] = current_tick + bank->groups[g].period_ticks;
+        }
+    }
+    return due;
+}
+
+static void bank_shift_timers(button_bank_t* bank, uint32_t delta) {
+    for (uint8_t g = 0; g < bank->group_count; g++) {
+        bank->group_due[g] += delta;
+    }
+    for (uint16_t i = 0; i < bank->count; i++) {
+        button_bank_state_t *st = &bank->states[i];
+        st->last_change_tick += delta;
+        st->press_start_tick += delta;
+        st->last_hold_tick += delta;
+        bank_mark_dirty(bank, i);
+    }
+}
+
+static unsigned int lowest_bit(uint32_t word) {
+#if defined(__GNUC__)
+    return (unsigned int)__builtin_ctz(word);
+#else
+    unsigned int bit = 0;
+    while (!(word & 1u)) { word >>= 1; bit++; }
+    return bit;
+#endif
+}
+
+/*
+ * Masks are caller-provided RAM of BUTTON_BANK_MASK_WORDS(count) words each.
+ * Every button starts enabled. Must be called before the bank is swept.
+ */
+button_error_t Button_BankConfigMasks(button_bank_t* bank, button_bank_mask_t* enabled, button_bank_mask_t* restart) {
+    if (!bank || !enabled || !restart) return BUTTON_ERR_INVALID_ARG;
+    if (!bank->entries) return BUTTON_ERR_NOT_INIT;
+
+    for (uint16_t w = 0; w < BUTTON_BANK_MASK_WORDS(bank->count); w++) {
+        uint16_t left = (uint16_t)(bank->count - w * 32u);
+        uint32_t word = (left >= 32u) ? 0xFFFFFFFFu : ((1UL << left) - 1u);
+        atomic_init(&enabled[w], word);
+        atomic_init(&restart[w], 0);
+    }
+    bank->restart = restart;
+    bank->enabled = enabled;
+    return BUTTON_OK;
+}
+
+button_error_t Button_BankEnable(button_bank_t* bank, uint16_t index) {
+    if (!bank || index >= bank->count) return BUTTON_ERR_INVALID_ARG;
+    if (!bank->enabled) return BUTTON_ERR_NOT_INIT;
+
+    uint32_t bit = 1UL << (index % 32u);
+    if (atomic_load(&bank->enabled[index / 32u]) & bit) return BUTTON_OK;
+
+    /* Restart is requested first, so a sweep that sees the enable bit also sees it */
+    atomic_fetch_or(&bank->restart[index / 32u], bit);
+    atomic_fetch_or(&bank->enabled[index / 32u], bit);
+    return BUTTON_OK;
+}
+
+button_error_t Button_BankDisable(button_bank_t* bank, uint16_t index) {
+    if (!bank || index >= bank->count) return BUTTON_ERR_INVALID_ARG;
+    if (!bank->enabled) return BUTTON_ERR_NOT_INIT;
+
+    uint32_t bit = 1UL << (index % 32u);
+    if (!(atomic_fetch_and(&bank->enabled[index / 32u], ~bit) & bit)) return BUTTON_OK;
+
+    /* Disabled first, so the sweep that parks the button no longer samples it */
+    atomic_fetch_or(&bank->restart[index / 32u], bit);
+    return BUTTON_OK;
+}
+
+bool Button_BankIsEnabled(const button_bank_t* bank, uint16_t index) {
+    if (!bank || index >= bank->count) return false;
+    if (!bank->enabled) return true;
+
+    return (atomic_load(&bank->enabled[index / 32u]) & (1UL << (index % 32u))) != 0;
+}
+
+/*
+ * Power-on held detection for the whole bank, called once after init and
+ * before the first sweep. Buttons pressed now start pressed with a press
+ * back-dated by @p backdate_ticks; their first sweep dispatches
+ * BUTTON_EVENT_POWER_ON_HELD instead of BUTTON_EVENT_PRESSED.
+ */
+button_error_t Button_BankDetectHeld(button_bank_t* bank, uint32_t backdate_ticks) {
+    if (!bank) return BUTTON_ERR_INVALID_ARG;
+    if (!bank->states || !bank->read_pin_func || !bank->get_tick_func) return BUTTON_ERR_NOT_INIT;
+
+    uint32_t since = bank->get_tick_func() - backdate_ticks;
+    for (uint16_t i = 0; i < bank->count; i++) {
+        const button_bank_entry_t *entry = &bank->entries[i];
+        bool pin_state = (bool)bank->read_pin_func(entry->gpio_num);
+        bool is_pressed = (entry->active_level == BUTTON_ACTIVE_LOW) ? !pin_state : pin_state;
+        button_bank_state_t *st = &bank->states[i];
+        if (!is_pressed || st->state != STATE_IDLE) continue;
+
+        st->state = STATE_POWER_ON_HELD;
+        st->last_change_tick = since;
+        st->press_start_tick = since;
+        st->last_hold_tick = since;
+        bank_mark_dirty(bank, i);
+    }
+    return BUTTON_OK;
+}
+
+/*
+ * Moves one button to another entry of the published profile table with a
+ * single byte store; the sweep picks it up on the next sample. Configuration
+ * calls (this one and Button_BankPublishProfiles) come from one thread.
+ */
+button_error_t Button_BankSetProfile(button_bank_t* bank, uint16_t index, uint8_t profile) {
+    if (!bank || index >= bank->count) return BUTTON_ERR_INVALID_ARG;
+    if (!bank->states) return BUTTON_ERR_NOT_INIT;
+    if (profile >= bank->profile_count) return BUTTON_ERR_INVALID_ARG;
+
+    atomic_store_explicit(&bank->states[index].profile, profile, memory_order_relaxed);
+    bank_mark_dirty(bank, index);
+    return BUTTON_OK;
+}
+
+/*
+ * @p members is caller RAM of group_count * BUTTON_BANK_MASK_WORDS(count)
+ * words, filled here from the entries' group field. Every group is due on the
+ * first sweep. Must be called before the bank is swept.
+ */
+button_error_t Button_BankConfigGroups(button_bank_t* bank, const button_scan_group_t* groups, uint8_t group_count, uint32_t* members) {
+    if (!bank || !groups || !members || group_count == 0 || group_count > BUTTON_BANK_MAX_GROUPS) return BUTTON_ERR_INVALID_ARG;
+    if (!bank->entries) return BUTTON_ERR_NOT_INIT;
+
+    uint16_t words = (uint16_t)BUTTON_BANK_MASK_WORDS(bank->count);
+    for (uint16_t i = 0; i < bank->count; i++) {
+        if (bank->entries[i].group >= group_count) return BUTTON_ERR_INVALID_ARG;
+    }
+    for (uint32_t w = 0; w < (uint32_t)group_count * words; w++) {
+        members[w] = 0;
+    }
+    for (uint16_t i = 0; i < bank->count; i++) {
+        members[bank->entries[i].group * words + i / 32u] |= 1UL << (i % 32u);
+    }
+
+    uint32_t now = bank->get_tick_func();
+    for (uint8_t g = 0; g < group_count; g++) {
+        bank->group_due[g] = now;
+    }
+    bank->group_members = members;
+    bank->group_count = group_count;
+    bank->groups = groups;
+    return BUTTON_OK;
+}
+
+/* Earliest tick at which a sweep has work to do, for tickless scheduling of Button_BankUpdate */
+button_error_t Button_BankNextDue(const button_bank_t* bank, uint32_t* tick) {
+    if (!bank || !tick) return BUTTON_ERR_INVALID_ARG;
+    if (!bank->groups) return BUTTON_ERR_NOT_INIT;
+
+    uint32_t next = bank->group_due[0];
+    for (uint8_t g = 1; g < bank->group_count; g++) {
+        if ((int32_t)(bank->group_due[g] - next) < 0) next = bank->group_due[g];
+    }
+    *tick = next;
+    return BUTTON_OK;
+}
+
+#if BUTTON_FEATURE_DISPATCH
+/* Handler for keymap actions; must be set before the bank is swept */
+button_error_t Button_BankConfigActions(button_bank_t* bank, button_action_fn action_fn, void* context) {
+    if (!bank) return BUTTON_ERR_INVALID_ARG;
+    if (!bank->entries) return BUTTON_ERR_NOT_INIT;
+
+    bank->action_func = action_fn;
+    bank->action_context = context;
+    return BUTTON_OK;
+}
+
+/*
+ * Switches the UI mode. Events dispatched after the store use the new keymap;
+ * the old one may be reused once @p grace (optional) has elapsed.
+ */
+button_error_t Button_BankSetKeymap(button_bank_t* bank, const button_keymap_t* keymap, button_grace_t* grace) {
+    if (!bank) return BUTTON_ERR_INVALID_ARG;
+    if (!bank->entries) return BUTTON_ERR_NOT_INIT;
+    if (keymap && (!keymap->actions || keymap->count < bank->count)) return BUTTON_ERR_INVALID_ARG;
+
+    atomic_store(&bank->keymap, keymap);
+    if (grace) {
+        uint32_t seq = (uint32_t)atomic_load(&bank->sweep_seq);
+        *grace = (seq & 1u) ? seq + 1u : seq;
+    }
+    return BUTTON_OK;
+}
+#endif
+
+/*
+ * @p dirty is caller RAM of BUTTON_BANK_MASK_WORDS(count) words. Every button
+ * starts dirty, so the first drain carries the whole bank. Must be called
+ * before the bank is swept.
+ */
+button_error_t Button_BankConfigDirty(button_bank_t* bank, button_bank_mask_t* dirty) {
+    if (!bank || !dirty) return BUTTON_ERR_INVALID_ARG;
+    if (!bank->entries) return BUTTON_ERR_NOT_INIT;
+
+    for (uint16_t w = 0; w < BUTTON_BANK_MASK_WORDS(bank->count); w++) {
+        uint16_t left = (uint16_t)(bank->count - w * 32u);
+        atomic_init(&dirty[w], (left >= 32u) ? 0xFFFFFFFFu : ((1UL << left) - 1u));
+    }
+    bank->dirty = dirty;
+    return BUTTON_OK;
+}
+
+/* @p latency is caller RAM of one button_latency_t per button. Must be called before the bank is swept. */
+button_error_t Button_BankConfigLatency(button_bank_t* bank, button_latency_t* latency) {
+    if (!bank || !latency) return BUTTON_ERR_INVALID_ARG;
+    if (!bank->entries) return BUTTON_ERR_NOT_INIT;
+
+    for (uint16_t i = 0; i < bank->count; i++) {
+        atomic_init(&latency[i].seq, 0);
+        ButtonLatency_Reset(&latency[i]);
+        atomic_init(&latency[i].edge_tick, 0);
+        atomic_init(&latency[i].edge_valid, false);
+    }
+    bank->latency = latency;
+    return BUTTON_OK;
+}
+
+/*
+ * @p page is caller memory of BUTTON_MONITOR_PAGE_SIZE(count) bytes, plain
+ * RAM or a shared mapping (ButtonMonitor_Create). Filled from the current
+ * states here; must be called before the bank is swept.
+ */
+button_error_t Button_BankConfigMonitor(button_bank_t* bank, button_monitor_page_t* page) {
+    if (!bank || !page) return BUTTON_ERR_INVALID_ARG;
+    if (!bank->states || !bank->get_tick_func) return BUTTON_ERR_NOT_INIT;
+
+    page->version = BUTTON_MONITOR_VERSION;
+    page->count = bank->count;
+    atomic_init(&page->seq, 0);
+    atomic_init(&page->tick, bank->get_tick_func());
+    for (uint16_t i = 0; i < bank->count; i++) {
+        const button_bank_state_t *st = &bank->states[i];
+        atomic_init(&page->slots[i].status, BUTTON_MONITOR_STATUS(st->state, BUTTON_EVENT_NONE));
+        atomic_init(&page->slots[i].press_start_tick, st->last_change_tick);
+        atomic_init(&page->slots[i].last_event_tick, 0);
+    }
+    /* Readers that attach early see the page only once it is complete */
+    atomic_thread_fence(memory_order_release);
+    page->magic = BUTTON_MONITOR_MAGIC;
+
+    bank->monitor = page;
+    bank->monitor_open = false;
+    return BUTTON_OK;
+}
+
+/*
+ * Called from the GPIO edge interrupt with the tick of the edge. Only the
+ * first edge of a transition counts: later bounce edges are ignored until the
+ * transition dispatches its event or is rejected by the debounce. An edge
+ * after which the next sweep still samples the settled level (bounce after
+ * the event, a glitch while idle) is dropped by that sweep.
+ */
+button_error_t Button_BankMarkEdge(button_bank_t* bank, uint16_t index, uint32_t tick) {
+    if (!bank || index >= bank->count) return BUTTON_ERR_INVALID_ARG;
+    if (!bank->latency) return BUTTON_ERR_NOT_INIT;
+
+    button_latency_t *lat = &bank->latency[index];
+    if (!atomic_load_explicit(&lat->edge_valid, memory_order_relaxed)) {
+        atomic_store_explicit(&lat->edge_tick, tick, memory_order_relaxed);
+        atomic_store_explicit(&lat->edge_valid, true, memory_order_release);
+    }
+    return BUTTON_OK;
+}
+
+/* Takes effect at the next sweep; the pause is measured from that sweep's tick */
+button_error_t Button_BankSuspend(button_bank_t* bank) {
+    if (!bank) return BUTTON_ERR_INVALID_ARG;
+    if (!bank->entries) return BUTTON_ERR_NOT_INIT;
+
+    atomic_store_explicit(&bank->suspended, true, memory_order_release);
+    return BUTTON_OK;
+}
+
+button_error_t Button_BankResume(button_bank_t* bank) {
+    if (!bank) return BUTTON_ERR_INVALID_ARG;
+    if (!bank->entries) return BUTTON_ERR_NOT_INIT;
+
+    atomic_store_explicit(&bank->suspended, false, memory_order_release);
+    return BUTTON_OK;
+}
+
+/*
+ * Stage latches of a press in progress are kept across a swap: stages that
+ * already fired stay fired, and latch bits beyond the new stage count are
+ * ignored. The new timings apply from the next sweep.
+ */
+button_error_t Button_BankPublishProfiles(button_bank_t* bank, const button_profile_t* profiles, uint8_t profile_count, button_grace_t* grace) {
+    if (!bank || !profiles || profile_count == 0 || !grace) return BUTTON_ERR_INVALID_ARG;
+    if (!bank->entries) return BUTTON_ERR_NOT_INIT;
+
+    for (uint8_t p = 0; p < profile_count; p++) {
+        if (!validate_profile(&profiles[p])) return BUTTON_ERR_INVALID_STAGES;
+    }
+    for (uint16_t i = 0; i < bank->count; i++) {
+        if (atomic_load_explicit(&bank->states[i].profile, memory_order_relaxed) >= profile_count) return BUTTON_ERR_INVALID_ARG;
+    }
+
+    atomic_store(&bank->profiles, profiles);
+    bank->profile_count = profile_count;
+
+    /* A sweep in progress may still use the old table until it ends */
+    uint32_t seq = (uint32_t)atomic_load(&bank->sweep_seq);
+    *grace = (seq & 1u) ? seq + 1u : seq;
+    return BUTTON_OK;
+}
+
+bool Button_BankGraceElapsed(const button_bank_t* bank, button_grace_t grace) {
+    if (!bank) return false;
+
+    uint32_t seq = (uint32_t)atomic_load(&bank->sweep_seq);
+    return (int32_t)(seq - grace) >= 0;
+}
+
+/* Same transitions as handle_state_* in button_static.c, with profile timings */
+static void bank_step(button_bank_t* bank, const button_profile_t* profiles, uint16_t index, bool is_pressed, uint32_t current_tick) {
+    button_bank_state_t *st = &bank->states[index];
+    const button_profile_t *profile = &profiles[atomic_load_explicit(&st->profile, memory_order_relaxed)];
+    uint32_t diff = current_tick - st->last_change_tick;
+
+    switch (st->state) {
+        case STATE_IDLE:
+            if (is_pressed) {
+                st->state = STATE_DEBOUNCE;
+                st->last_change_tick = current_tick;
+                bank_mark_dirty(bank, index);
+                bank_latency_edge(bank, index, current_tick);
+            } else {
+                bank_latency_settled(bank, index);
+            }
+            break;
+
+        case STATE_DEBOUNCE:
+            if (diff >= profile->debounce_ticks) {
+                if (is_pressed) {
+                    st->state = STATE_PRESSED;
+                    st->last_change_tick = current_tick;
+                    bank_dispatch(bank, index, BUTTON_EVENT_PRESSED);
+                    bank_latency_event(bank, index, current_tick);
+                } else {
+                    st->state = STATE_IDLE;
+                    bank_mark_dirty(bank, index);
+                    /* Rejected as bounce: the next press starts a new measurement */
+                    bank_latency_settled(bank, index);
+                }
+            }
+            break;
+
+        case STATE_POWER_ON_HELD:
+            st->state = STATE_PRESSED;
+            bank_dispatch(bank, index, BUTTON_EVENT_POWER_ON_HELD);
+            /* fall through */
+        case STATE_PRESSED:
+            if (!is_pressed) {
+                st->state = STATE_IDLE;
+                bank_dispatch(bank, index, BUTTON_EVENT_RELEASED);
+                bank_latency_event(bank, index, current_tick);
+                break;
+            }
+            bank_latency_settled(bank, index);
+            if (diff >= profile->long_press_ticks) {
+                st->state = STATE_LONG_PRESSED;
+                st->last_change_tick = current_tick;
+                st->press_start_tick = current_tick;
+                st->last_hold_tick = current_tick;
+                st->hold_stage = 0;
+                bank_dispatch(bank, index, BUTTON_EVENT_LONG_PRESSED);
+            }
+            break;
+
+        case STATE_LONG_PRESSED: {
+            if (!is_pressed) {
+                st->state = STATE_IDLE;
+                st->latches = 0;
+                bank_dispatch(bank, index, BUTTON_EVENT_RELEASED);
+                bank_latency_event(bank, index, current_tick);
+                break;
+            }
+            bank_latency_settled(bank, index);
+
+            uint32_t total_pressed_time = current_tick - st->press_start_tick;
+#if BUTTON_FEATURE_SUPER_LONG
+            if (total_pressed_time >= BUTTON_SUPER_LONG_PRESS_TICKS && !(st->latches & BUTTON_BANK_SUPER_LONG_LATCH)) {
+                st->latches |= BUTTON_BANK_SUPER_LONG_LATCH;
+                bank_dispatch(bank, index, BUTTON_EVENT_SUPER_LONG_PRESSED);
+            }
+#endif
+#if BUTTON_FEATURE_STAGES
+            for (uint8_t s = 0; s < profile->stage_count; s++) {
+                uint32_t bit = 1UL << s;
+                if (total_pressed_time >= profile->stages[s].threshold && !(st->latches & bit)) {
+                    st->latches |= bit;
+                    if (profile->stages[s].hold_ticks != 0) st->hold_stage = (uint8_t)(s + 1u);
+                    bank_dispatch_stage(bank, index, profile->stages[s].event, s, profile->stages[s].threshold);
+                }
+            }
+#endif
+
+#if BUTTON_FEATURE_HOLD
+            /* A stage beyond a swapped-in, shorter table falls back to the profile interval */
+            uint32_t hold_ticks = (st->hold_stage != 0 && st->hold_stage <= profile->stage_count) ?
+                                  profile->stages[st->hold_stage - 1u].hold_ticks : profile->hold_ticks;
+            if (total_pressed_time >= profile->long_press_ticks && hold_ticks != BUTTON_HOLD_OFF &&
+                (current_tick - st->last_hold_tick) >= hold_ticks) {
+                st->last_hold_tick = current_tick;
+                bank_dispatch(bank, index, BUTTON_EVENT_HOLD);
+            }
+#endif
+            (void)total_pressed_time;
+            break;
+        }
+
+        default:
+            st->state = STATE_IDLE;
+            bank_mark_dirty(bank, index);
+            break;
+    }
+}
+
+static void bank_dispatch(button_bank_t* bank, uint16_t index, button_event_t event) {
+    bank_dispatch_stage(bank, index, event, BUTTON_STAGE_NONE, 0);
+}
+
+/* Entry handlers are const; the bank handler is read with the same seqlock as button_t */
+static void bank_dispatch_stage(button_bank_t* bank, uint16_t index, button_event_t event, uint8_t stage, uint32_t threshold) {
+    /* Every event follows a state change of the button */
+    bank_mark_dirty(bank, index);
+    if (bank->monitor) bank_monitor_event(bank, index, event);
+    bank->sweep_events |= BUTTON_EVENT_BIT(event);
+    bank->sweep_event_count++;
+
+#if BUTTON_FEATURE_DISPATCH
+    const button_bank_entry_t *entry = &bank->entries[index];
+    button_bank_callback_fn callback;
+#if BUTTON_FEATURE_STAGES
+    button_bank_stage_callback_fn stage_callback;
+#endif
+    void* context;
+    unsigned int seq;
+
+    if (entry->callback) {
+        entry->callback(event, entry->context);
+    }
+
+    do {
+        /* seq_cst like the profile load in bank_sweep, for Button_BankHandlerGrace */
+        seq = atomic_load(&bank->handler_seq);
+        button_bank_handler_t *h = &bank->handlers[seq & 1u];
+        callback = atomic_load_explicit(&h->callback, memory_order_relaxed);
+#if BUTTON_FEATURE_STAGES
+        stage_callback = atomic_load_explicit(&h->stage_callback, memory_order_relaxed);
+#endif
+        context = atomic_load_explicit(&h->context, memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+    } while (seq != atomic_load_explicit(&bank->handler_seq, memory_order_relaxed));
+
+#if BUTTON_FEATURE_STAGES
+    if (stage != BUTTON_STAGE_NONE && stage_callback) {
+        stage_callback(index, event, stage, threshold, context);
+    } else if (callback) {
+        callback(index, event, context);
+    }
+#else
+    if (callback) {
+        callback(index, event, context);
+    }
+#endif
+
+    /* seq_cst against Button_BankSetKeymap's grace, as the profile load in bank_sweep */
+    const button_keymap_t *keymap = atomic_load(&bank->keymap);
+    if (keymap && bank->action_func) {
+        button_action_t action = keymap->actions[(uint32_t)index * BUTTON_EVENT_MAX + (uint32_t)event];
+        if (action != BUTTON_ACTION_NONE) {
+            bank->action_func(index, action, bank->action_context);
+        }
+    }
+#endif
+    (void)stage;
+    (void)threshold;
+}
+
+/* Release: whoever drains the bit also sees the state written before it (Button_BankSetProfile runs on another thread) */
+static void bank_mark_dirty(button_bank_t* bank, uint16_t index) {
+    if (bank->dirty) {
+        atomic_fetch_or_explicit(&bank->dirty[index / 32u], 1UL << (index % 32u), memory_order_release);
+    }
+}
+
+/* First-seen sample: stands in for the edge when no interrupt reported one */
+static void bank_latency_edge(button_bank_t* bank, uint16_t index, uint32_t current_tick) {
+    if (!bank->latency) return;
+
+    button_latency_t *lat = &bank->latency[index];
+    if (!atomic_load_explicit(&lat->edge_valid, memory_order_acquire)) {
+        atomic_store_explicit(&lat->edge_tick, current_tick, memory_order_relaxed);
+        atomic_store_explicit(&lat->edge_valid, true, memory_order_relaxed);
+    }
+}
+
+/* Called once the handlers of the event returned: a slow sweep ahead of the button and the handlers count */
+static void bank_latency_event(button_bank_t* bank, uint16_t index, uint32_t current_tick) {
+    if (!bank->latency) return;
+
+    button_latency_t *lat = &bank->latency[index];
+    uint32_t edge = current_tick;
+    if (atomic_load_explicit(&lat->edge_valid, memory_order_acquire)) {
+        edge = atomic_load_explicit(&lat->edge_tick, memory_order_relaxed);
+    }
+    atomic_store_explicit(&lat->edge_valid, false, memory_order_relaxed);
+    ButtonLatency_Record(lat, bank->get_tick_func() - edge);
+}
+
+/* The sweep saw the level the FSM already settled at: edges marked since then were bounce or glitches */
+static void bank_latency_settled(button_bank_t* bank, uint16_t index) {
+    if (bank->latency && atomic_load_explicit(&bank->latency[index].edge_valid, memory_order_relaxed)) {
+        atomic_store_explicit(&bank->latency[index].edge_valid, false, memory_order_relaxed);
+    }
+}
+
+/* First write of a sweep makes the page sequence odd; quiet sweeps never do */
+static void bank_monitor_open(button_bank_t* bank) {
+    if (bank->monitor_open) return;
+
+    uint32_t seq = (uint32_t)atomic_load_explicit(&bank->monitor->seq, memory_order_relaxed);
+    atomic_store_explicit(&bank->monitor->seq, seq + 1u, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    bank->monitor_open = true;
+}
+
+static void bank_monitor_close(button_bank_t* bank, uint32_t current_tick) {
+    button_monitor_page_t *page = bank->monitor;
+
+    atomic_store_explicit(&page->tick, current_tick, memory_order_relaxed);
+    if (bank->monitor_open) {
+        uint32_t seq = (uint32_t)atomic_load_explicit(&page->seq, memory_order_relaxed);
+        atomic_store_explicit(&page->seq, seq + 1u, memory_order_release);
+        bank->monitor_open = false;
+    }
+}
+
+/* Transitions without an event (debounce, restart): one compare per sample when nothing changed */
+static void bank_monitor_state(button_bank_t* bank, uint16_t index) {
+    button_monitor_slot_t *slot = &bank->monitor->slots[index];
+    uint32_t status = (uint32_t)atomic_load_explicit(&slot->status, memory_order_relaxed);
+    uint8_t state = bank->states[index].state;
+    if (BUTTON_MONITOR_STATE(status) == state) return;
+
+    bank_monitor_open(bank);
+    atomic_store_explicit(&slot->status, BUTTON_MONITOR_STATUS(state, BUTTON_MONITOR_EVENT(status)), memory_order_relaxed);
+}
+
+/* The state is already updated when an event is dispatched */
+static void bank_monitor_event(button_bank_t* bank, uint16_t index, button_event_t event) {
+    button_monitor_slot_t *slot = &bank->monitor->slots[index];
+    const button_bank_state_t *st = &bank->states[index];
+
+    bank_monitor_open(bank);
+    atomic_store_explicit(&slot->status, BUTTON_MONITOR_STATUS(st->state, event), memory_order_relaxed);
+    atomic_store_explicit(&slot->last_event_tick, bank->sweep_tick, memory_order_relaxed);
+    /* PRESSED starts the press at its debounce exit; POWER_ON_HELD at the back-dated detection */
+    if (event == BUTTON_EVENT_PRESSED || event == BUTTON_EVENT_POWER_ON_HELD) {
+        atomic_store_explicit(&slot->press_start_tick, st->last_change_tick, memory_order_relaxed);
+    }
+}
+
+#if BUTTON_FEATURE_DISPATCH
+button_error_t Button_BankRegisterHandler(button_bank_t* bank, button_bank_callback_fn callback, void* context) {
+#if BUTTON_FEATURE_STAGES
+    return Button_BankRegisterHandlerEx(bank, callback, NULL, context);
+#else
+    if (!bank) return BUTTON_ERR_INVALID_ARG;
+
+    publish_handler(bank, callback, context);
+    return BUTTON_OK;
+#endif
+}
+
+#if BUTTON_FEATURE_STAGES
+/* Stage events go to @p stage_callback when set, see Button_RegisterHandlerEx */
+button_error_t Button_BankRegisterHandlerEx(button_bank_t* bank, button_bank_callback_fn callback,
+                                            button_bank_stage_callback_fn stage_callback, void* context) {
+    if (!bank) return BUTTON_ERR_INVALID_ARG;
+
+    publish_handler(bank, callback, stage_callback, context);
+    return BUTTON_OK;
+}
+#endif
+
+button_error_t Button_BankUnregisterHandler(button_bank_t* bank) {
+    if (!bank) return BUTTON_ERR_INVALID_ARG;
+
+#if BUTTON_FEATURE_STAGES
+    publish_handler(bank, NULL, NULL, NULL);
+#else
+    publish_handler(bank, NULL, NULL);
+#endif
+    return BUTTON_OK;
+}
+
+/*
+ * Grace of the handler set replaced by the last (un)registration, taken by
+ * the thread that made it. Every dispatch runs inside a sweep, so once
+ * Button_BankGraceElapsed reports @p grace, the old callback has returned and
+ * its context may be freed.
+ */
+button_error_t Button_BankHandlerGrace(const button_bank_t* bank, button_grace_t* grace) {
+    if (!bank || !grace) return BUTTON_ERR_INVALID_ARG;
+    if (!bank->entries) return BUTTON_ERR_NOT_INIT;
+
+    uint32_t seq = (uint32_t)atomic_load(&bank->sweep_seq);
+    *grace = (seq & 1u) ? seq + 1u : seq;
+    return BUTTON_OK;
+}
+
+/* Single writer, see publish_handler in button_static.c */
+#if BUTTON_FEATURE_STAGES
+static void publish_handler(button_bank_t* bank, button_bank_callback_fn callback, button_bank_stage_callback_fn stage_callback, void* context) {
+#else
+static void publish_handler(button_bank_t* bank, button_bank_callback_fn callback, void* context) {
+#endif
+    unsigned int seq = atomic_load_explicit(&bank->handler_seq, memory_order_relaxed);
+    button_bank_handler_t *h = &bank->handlers[(seq + 1u) & 1u];
+
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&h->callback, callback, memory_order_relaxed);
+    atomic_store_explicit(&h->context, context, memory_order_relaxed);
+#if BUTTON_FEATURE_STAGES
+    atomic_store_explicit(&h->stage_callback, stage_callback, memory_order_relaxed);
+#endif
+    /* seq_cst, so a later Button_BankHandlerGrace does not read sweep_seq ahead of it */
+    atomic_store(&bank->handler_seq, seq + 1u);
+}
+#endif
+
+button_error_t Button_BankDeinit(button_bank_t* bank) {
+    if (!bank) return BUTTON_ERR_INVALID_ARG;
+
+    *bank = (button_bank_t){0};
+    return BUTTON_OK;
+}
+
+/* Without BUTTON_FEATURE_STAGES a profile must not carry a stage table: it would be ignored */
+static bool validate_profile(const button_profile_t* profile) {
+    if (profile->stage_count == 0) return true;
+#if BUTTON_FEATURE_STAGES
+    if (!profile->stages || profile->stage_count > BUTTON_BANK_MAX_STAGES) return false;
+    if (profile->stages[0].threshold == 0) return false;
+    for (uint8_t i = 0; i < profile->stage_count; i++) {
+        /* The event indexes the keymap row and the event mask */
+        if (profile->stages[i].event == BUTTON_EVENT_NONE || profile->stages[i].event >= BUTTON_EVENT_MAX) return false;
+        if (i > 0 && profile->stages[i].threshold <= profile->stages[i - 1].threshold) return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,180 @@
+#include    <stdbool.h>
+#include    <stdint.h>
+#include    <stddef.h>
+#include    <string.h>
+#include    "button_hid.h"
+
+static void boot_press(button_hid_t* hid, uint8_t usage);
+static void boot_release(button_hid_t* hid, uint8_t usage);
+static void boot_refill(button_hid_t* hid);
+static unsigned int lowest_bit(uint32_t word);
+
+
+/*
+ * @p usages has one entry per bank index. A usage may appear only once, and
+ * the error codes 0x01..0x03 and the reserved range above Right GUI are
+ * rejected. Starts in boot protocol with no key down.
+ */
+button_error_t ButtonHid_Init(button_hid_t* hid, const uint8_t* usages, uint16_t count) {
+    uint32_t seen[256u / 32u] = { 0 };
+    if (!hid || !usages || count == 0) return BUTTON_ERR_INVALID_ARG;
+
+    for (uint16_t i = 0; i < count; i++) {
+        uint8_t u = usages[i];
+        if (u == BUTTON_HID_USAGE_NONE) continue;
+        if (u <= 0x03u || u > BUTTON_HID_MODIFIER_LAST) return BUTTON_ERR_INVALID_ARG;
+        if (seen[u / 32u] & (1UL << (u % 32u))) return BUTTON_ERR_INVALID_ARG;
+        seen[u / 32u] |= 1UL << (u % 32u);
+    }
+
+    memset(hid, 0, sizeof(*hid));
+    hid->usages = usages;
+    hid->count = count;
+    hid->boot_changed = true;   /* The host gets the empty report first */
+    hid->nkro_changed = true;
+    atomic_init(&hid->protocol, BUTTON_HID_PROTOCOL_BOOT);
+    hid->sent_protocol = BUTTON_HID_PROTOCOL_BOOT;
+    return BUTTON_OK;
+}
+
+/* Safe from the USB control handler; the next report taken uses the new protocol */
+button_error_t ButtonHid_SetProtocol(button_hid_t* hid, button_hid_protocol_t protocol) {
+    if (!hid || (protocol != BUTTON_HID_PROTOCOL_BOOT && protocol != BUTTON_HID_PROTOCOL_NKRO)) return BUTTON_ERR_INVALID_ARG;
+
+    atomic_store_explicit(&hid->protocol, (uint8_t)protocol, memory_order_relaxed);
+    return BUTTON_OK;
+}
+
+/* Updates both reports in place; a repeated press or release changes nothing */
+button_error_t ButtonHid_SetKey(button_hid_t* hid, uint16_t index, bool pressed) {
+    if (!hid || !hid->usages || index >= hid->count) return BUTTON_ERR_INVALID_ARG;
+
+    uint8_t u = hid->usages[index];
+    if (u == BUTTON_HID_USAGE_NONE) return BUTTON_OK;
+
+    if (u >= BUTTON_HID_MODIFIER_FIRST) {
+        uint8_t bit = (uint8_t)(1u << (u - BUTTON_HID_MODIFIER_FIRST));
+        uint8_t mods = pressed ? (uint8_t)(hid->boot[0] | bit) : (uint8_t)(hid->boot[0] & ~bit);
+        if (mods == hid->boot[0]) return BUTTON_OK;
+        hid->boot[0] = mods;
+        hid->nkro[0] = mods;
+        hid->boot_changed = true;
+        hid->nkro_changed = true;
+        return BUTTON_OK;
+    }
+
+    uint32_t mask = 1UL << (u % 32u);
+    if (((hid->pressed[u / 32u] & mask) != 0) == pressed) return BUTTON_OK;
+
+    hid->pressed[u / 32u] ^= mask;
+    hid->nkro[2u + u / 8u] ^= (uint8_t)(1u << (u % 8u));
+    hid->nkro_changed = true;
+    if (pressed) {
+        boot_press(hid, u);
+    } else {
+        boot_release(hid, u);
+    }
+    return BUTTON_OK;
+}
+
+/* Bank handler: PRESSED (or POWER_ON_HELD) puts the key down, RELEASED lifts it */
+void ButtonHid_OnEvent(uint16_t index, button_event_t event, void* context) {
+    button_hid_t *hid = (button_hid_t*)context;
+    if (!hid) return;
+
+    if (event == BUTTON_EVENT_PRESSED || event == BUTTON_EVENT_POWER_ON_HELD) {
+        ButtonHid_SetKey(hid, index, true);
+    } else if (event == BUTTON_EVENT_RELEASED) {
+        ButtonHid_SetKey(hid, index, false);
+    }
+}
+
+/*
+ * Call from the sweeping thread after Button_BankUpdate. Copies the report of
+ * the current protocol when it changed since the last one taken, or when the
+ * protocol changed; @p len is 0 otherwise.
+ */
+button_error_t ButtonHid_TakeReport(button_hid_t* hid, uint8_t* buf, size_t cap, size_t* len) {
+    if (!hid || !buf || !len) return BUTTON_ERR_INVALID_ARG;
+    if (!hid->usages) return BUTTON_ERR_NOT_INIT;
+
+    uint8_t protocol = (uint8_t)atomic_load_explicit(&hid->protocol, memory_order_relaxed);
+    bool switched = protocol != hid->sent_protocol;
+    const uint8_t *report = hid->boot;
+    size_t size = BUTTON_HID_BOOT_REPORT_SIZE;
+    bool *changed = &hid->boot_changed;
+    if (protocol == BUTTON_HID_PROTOCOL_NKRO) {
+        report = hid->nkro;
+        size = BUTTON_HID_NKRO_REPORT_SIZE;
+        changed = &hid->nkro_changed;
+    }
+    if (cap < size) return BUTTON_ERR_INVALID_ARG;
+
+    if (!*changed && !switched) {
+        *len = 0;
+        return BUTTON_OK;
+    }
+    memcpy(buf, report, size);
+    *changed = false;
+    hid->sent_protocol = protocol;
+    *len = size;
+    return BUTTON_OK;
+}
+
+static void boot_press(button_hid_t* hid, uint8_t usage) {
+    hid->key_count++;
+    if (hid->key_count <= BUTTON_HID_BOOT_KEYS) {
+        hid->boot[2u + hid->boot_keys++] = usage;
+        hid->boot_changed = true;
+    } else if (hid->key_count == BUTTON_HID_BOOT_KEYS + 1) {
+        memset(&hid->boot[2], BUTTON_HID_ERROR_ROLLOVER, BUTTON_HID_BOOT_KEYS);
+        hid->boot_keys = 0;
+        hid->boot_changed = true;
+    }
+    /* Further keys while rolled over leave the boot report as it is */
+}
+
+/* Remaining slots keep their press order */
+static void boot_release(button_hid_t* hid, uint8_t usage) {
+    hid->key_count--;
+    if (hid->key_count == BUTTON_HID_BOOT_KEYS) {
+        boot_refill(hid);
+        return;
+    }
+    if (hid->key_count > BUTTON_HID_BOOT_KEYS) return;
+
+    uint8_t *slots = &hid->boot[2];
+    for (uint8_t s = 0; s < hid->boot_keys; s++) {
+        if (slots[s] != usage) continue;
+        memmove(&slots[s], &slots[s + 1u], (size_t)(hid->boot_keys - s - 1u));
+        slots[--hid->boot_keys] = 0;
+        hid->boot_changed = true;
+        return;
+    }
+}
+
+/* Leaving rollover: the press order of the remaining keys is gone, so they are listed by usage */
+static void boot_refill(button_hid_t* hid) {
+    uint8_t n = 0;
+
+    for (uint8_t w = 0; w < BUTTON_HID_PRESSED_WORDS && n < BUTTON_HID_BOOT_KEYS; w++) {
+        uint32_t word = hid->pressed[w];
+        while (word && n < BUTTON_HID_BOOT_KEYS) {
+            hid->boot[2u + n++] = (uint8_t)(w * 32u + lowest_bit(word));
+            word &= word - 1u;
+        }
+    }
+    memset(&hid->boot[2u + n], 0, (size_t)(BUTTON_HID_BOOT_KEYS - n));
+    hid->boot_keys = n;
+    hid->boot_changed = true;
+}
+
+static unsigned int lowest_bit(uint32_t word) {
+#if defined(__GNUC__)
+    return (unsigned int)__builtin_ctz(word);
+#else
+    unsigned int bit = 0;
+    while (!(word & 1u)) { word >>= 1; bit++; }
+    return bit;
+#endif
+}
@@ -0,0 +1,115 @@
+#include    <stdbool.h>
+#include    <stdint.h>
+#include    <stddef.h>
+#include    "button_latency.h"
+
+static uint8_t bucket_of(uint32_t ticks);
+static void write_begin(button_latency_t* latency);
+static void write_end(button_latency_t* latency);
+
+
+/* Clears the histogram; a pending edge is kept */
+void ButtonLatency_Reset(button_latency_t* latency) {
+    if (!latency) return;
+
+    write_begin(latency);
+    atomic_store_explicit(&latency->count, 0, memory_order_relaxed);
+    atomic_store_explicit(&latency->max_ticks, 0, memory_order_relaxed);
+    atomic_store_explicit(&latency->sum_lo, 0, memory_order_relaxed);
+    atomic_store_explicit(&latency->sum_hi, 0, memory_order_relaxed);
+    for (uint8_t b = 0; b < BUTTON_LATENCY_BUCKETS; b++) {
+        atomic_store_explicit(&latency->buckets[b], 0, memory_order_relaxed);
+    }
+    write_end(latency);
+}
+
+/* Single writer: plain read-modify-write of each field, published by the sequence */
+void ButtonLatency_Record(button_latency_t* latency, uint32_t ticks) {
+    if (!latency) return;
+
+    uint32_t count = (uint32_t)atomic_load_explicit(&latency->count, memory_order_relaxed);
+    uint32_t max_ticks = (uint32_t)atomic_load_explicit(&latency->max_ticks, memory_order_relaxed);
+    uint32_t sum_lo = (uint32_t)atomic_load_explicit(&latency->sum_lo, memory_order_relaxed);
+    uint32_t sum_hi = (uint32_t)atomic_load_explicit(&latency->sum_hi, memory_order_relaxed);
+    uint8_t b = bucket_of(ticks);
+    uint32_t bucket = (uint32_t)atomic_load_explicit(&latency->buckets[b], memory_order_relaxed);
+
+    if (sum_lo + ticks < sum_lo) sum_hi++;
+    sum_lo += ticks;
+
+    write_begin(latency);
+    atomic_store_explicit(&latency->count, count + 1u, memory_order_relaxed);
+    atomic_store_explicit(&latency->sum_lo, sum_lo, memory_order_relaxed);
+    atomic_store_explicit(&latency->sum_hi, sum_hi, memory_order_relaxed);
+    if (ticks > max_ticks) atomic_store_explicit(&latency->max_ticks, ticks, memory_order_relaxed);
+    atomic_store_explicit(&latency->buckets[b], bucket + 1u, memory_order_relaxed);
+    write_end(latency);
+}
+
+/*
+ * Copies the histogram as of one Record. Fails with BUTTON_ERR_UNKNOWN when
+ * every attempt overlapped a write, e.g. a reader that preempts the sweep on
+ * its own core.
+ */
+button_error_t ButtonLatency_Snapshot(const button_latency_t* latency, button_latency_snapshot_t* snapshot) {
+    if (!latency || !snapshot) return BUTTON_ERR_INVALID_ARG;
+
+    for (uint32_t attempt = 0; attempt < BUTTON_LATENCY_READ_RETRIES; attempt++) {
+        uint32_t seq = (uint32_t)atomic_load_explicit(&latency->seq, memory_order_acquire);
+        if (seq & 1u) continue;
+
+        snapshot->count = (uint32_t)atomic_load_explicit(&latency->count, memory_order_relaxed);
+        snapshot->max_ticks = (uint32_t)atomic_load_explicit(&latency->max_ticks, memory_order_relaxed);
+        snapshot->sum_ticks = ((uint64_t)atomic_load_explicit(&latency->sum_hi, memory_order_relaxed) << 32)
+                            | (uint32_t)atomic_load_explicit(&latency->sum_lo, memory_order_relaxed);
+        for (uint8_t b = 0; b < BUTTON_LATENCY_BUCKETS; b++) {
+            snapshot->buckets[b] = (uint32_t)atomic_load_explicit(&latency->buckets[b], memory_order_relaxed);
+        }
+        atomic_thread_fence(memory_order_acquire);
+
+        if (seq == (uint32_t)atomic_load_explicit(&latency->seq, memory_order_relaxed)) return BUTTON_OK;
+    }
+    return BUTTON_ERR_UNKNOWN;
+}
+
+/*
+ * Smallest bucket bound that at least @p percent of the events stay within.
+ * The open-ended last bucket reports max_ticks.
+ */
+button_error_t ButtonLatency_Percentile(const button_latency_snapshot_t* snapshot, uint8_t percent, uint32_t* ticks) {
+    if (!snapshot || !ticks || percent == 0 || percent > 100) return BUTTON_ERR_INVALID_ARG;
+    if (snapshot->count == 0) return BUTTON_ERR_NOT_INIT;
+
+    uint64_t target = ((uint64_t)snapshot->count * percent + 99u) / 100u;
+    uint64_t seen = 0;
+    for (uint8_t b = 0; b < BUTTON_LATENCY_BUCKETS - 1u; b++) {
+        seen += snapshot->buckets[b];
+        if (seen >= target) {
+            uint32_t bound = (b == 0) ? 0u : (1UL << b) - 1u;
+            *ticks = (bound < snapshot->max_ticks) ? bound : snapshot->max_ticks;
+            return BUTTON_OK;
+        }
+    }
+    *ticks = snapshot->max_ticks;
+    return BUTTON_OK;
+}
+
+static uint8_t bucket_of(uint32_t ticks) {
+    uint8_t b = 0;
+    while (ticks != 0 && b < BUTTON_LATENCY_BUCKETS - 1u) {
+        ticks >>= 1;
+        b++;
+    }
+    return b;
+}
+
+static void write_begin(button_latency_t* latency) {
+    uint32_t seq = (uint32_t)atomic_load_explicit(&latency->seq, memory_order_relaxed);
+    atomic_store_explicit(&latency->seq, seq + 1u, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+static void write_end(button_latency_t* latency) {
+    uint32_t seq = (uint32_t)atomic_load_explicit(&latency->seq, memory_order_relaxed);
+    atomic_store_explicit(&latency->seq, seq + 1u, memory_order_release);
+}
@@ -0,0 +1,91 @@
+#include    <stdbool.h>
+#include    <stdint.h>
+#include    <stddef.h>
+#include    "button_record.h"
+
+
+button_error_t ButtonRecord_LogInit(button_record_log_t* log, uint32_t* words, uint32_t capacity, get_tick_fn tick_fn) {
+    if (!log || !words || capacity <= BUTTON_RECORD_HEADER_WORDS) return BUTTON_ERR_INVALID_ARG;
+
+    *log = (button_record_log_t){
+        .words = words,
+        .capacity = capacity,
+        .used = 0,
+        .batch = 0,
+        .open = false,
+        .get_tick_func = tick_fn,
+        .dropped = 0,
+    };
+    return BUTTON_OK;
+}
+
+/* Ticks must not go backwards within the log; a later tick past the offset range opens a new batch */
+button_error_t ButtonRecord_Append(button_record_log_t* log, uint16_t index, button_event_t event, uint32_t tick) {
+    if (!log || !log->words || index > BUTTON_RECORD_MAX_INDEX || event >= BUTTON_EVENT_MAX) return BUTTON_ERR_INVALID_ARG;
+
+    uint32_t delta = tick - (log->open ? log->words[log->batch] : tick);
+    if (!log->open || delta > BUTTON_RECORD_MAX_DELTA) {
+        if (log->capacity - log->used < BUTTON_RECORD_HEADER_WORDS + 1u) {
+            log->dropped++;
+            return BUTTON_ERR_UNKNOWN;
+        }
+        log->batch = log->used;
+        log->words[log->batch] = tick;
+        log->words[log->batch + 1u] = 0;
+        log->used += BUTTON_RECORD_HEADER_WORDS;
+        log->open = true;
+        delta = 0;
+    } else if (log->used >= log->capacity) {
+        log->dropped++;
+        return BUTTON_ERR_UNKNOWN;
+    }
+
+    log->words[log->used++] = BUTTON_RECORD_PACK(index, event, delta);
+    log->words[log->batch + 1u]++;
+    return BUTTON_OK;
+}
+
+/* Bank handler: stamps the event with the log's tick source */
+void ButtonRecord_OnEvent(uint16_t index, button_event_t event, void* context) {
+    button_record_log_t *log = (button_record_log_t*)context;
+    if (!log || !log->get_tick_func) return;
+
+    ButtonRecord_Append(log, index, event, log->get_tick_func());
+}
+
+/* Empties the log once its words have been consumed (queued, written to the journal) */
+button_error_t ButtonRecord_LogReset(button_record_log_t* log) {
+    if (!log) return BUTTON_ERR_INVALID_ARG;
+
+    log->used = 0;
+    log->batch = 0;
+    log->open = false;
+    return BUTTON_OK;
+}
+
+button_error_t ButtonRecord_ReaderInit(button_record_reader_t* reader, const uint32_t* words, uint32_t used) {
+    if (!reader || (!words && used > 0)) return BUTTON_ERR_INVALID_ARG;
+
+    *reader = (button_record_reader_t){ .words = words, .used = used, .pos = 0, .left = 0, .base_tick = 0 };
+    return BUTTON_OK;
+}
+
+/* Returns false at the end of the words, or on a batch header that runs past them */
+bool ButtonRecord_Read(button_record_reader_t* reader, uint16_t* index, button_event_t* event, uint32_t* tick) {
+    if (!reader || !index || !event || !tick) return false;
+
+    while (reader->left == 0) {
+        if (reader->used - reader->pos < BUTTON_RECORD_HEADER_WORDS) return false;
+        reader->base_tick = reader->words[reader->pos];
+        reader->left = reader->words[reader->pos + 1u];
+        reader->pos += BUTTON_RECORD_HEADER_WORDS;
+        if (reader->left > reader->used - reader->pos) return false;
+    }
+
+    button_record_t rec = reader->words[reader->pos++];
+    reader->left--;
+    *index = BUTTON_RECORD_INDEX(rec);
+    *event = BUTTON_RECORD_EVENT(rec);
+    *tick = reader->base_tick + BUTTON_RECORD_DELTA(rec);
+    return true;
+}
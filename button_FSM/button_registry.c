@@ -0,0 +1,60 @@
+#include    <stdbool.h>
+#include    <stdint.h>
+#include    <stddef.h>
+#include    "button_registry.h"
+
+static const button_profile_t registry_default_profile = BUTTON_PROFILE_DEFAULT(NULL, 0);
+
+/*
+ * Weak references: the address is NULL when the application does not use
+ * BUTTON_REGISTRY_PROFILES / BUTTON_REGISTRY_HAL. (Weak const definitions
+ * would be folded into this translation unit and never overridden.)
+ */
+extern const button_profile_t *const button_registry_profiles __attribute__((weak));
+extern const uint8_t button_registry_profile_count __attribute__((weak));
+extern const button_read_gpio_fn button_registry_read_fn __attribute__((weak));
+extern const get_tick_fn button_registry_tick_fn __attribute__((weak));
+
+static button_bank_t registry_bank;
+
+static button_error_t registry_resolve(void);
+
+/*
+ * The bank is built from the section bounds the first time it is needed.
+ * Button_BankInit validates the profile table once and writes every state
+ * (IDLE, current tick), so the state section needs no startup clearing.
+ */
+static button_error_t registry_resolve(void) {
+    if (registry_bank.states) return BUTTON_OK;
+
+    const button_bank_entry_t *entries = BUTTON_REGISTRY_ENTRY_START;
+    button_bank_state_t *states = BUTTON_REGISTRY_STATE_START;
+    if (!entries || !states) return BUTTON_ERR_NOT_INIT;
+
+    size_t count = (size_t)(BUTTON_REGISTRY_ENTRY_STOP - entries);
+    if (count == 0 || count > UINT16_MAX) return BUTTON_ERR_NOT_INIT;
+    if ((size_t)(BUTTON_REGISTRY_STATE_STOP - states) != count) return BUTTON_ERR_NOT_INIT;
+
+    if (!&button_registry_read_fn || !&button_registry_tick_fn) return BUTTON_ERR_NOT_INIT;
+
+    const button_profile_t *profiles = &registry_default_profile;
+    uint8_t profile_count = 1;
+    if (&button_registry_profiles && &button_registry_profile_count) {
+        profiles = button_registry_profiles;
+        profile_count = button_registry_profile_count;
+    }
+
+    return Button_BankInit(&registry_bank, entries, states, (uint16_t)count, profiles, profile_count,
+                           button_registry_read_fn, button_registry_tick_fn);
+}
+
+button_error_t Button_RegistryUpdate(void) {
+    button_error_t err = registry_resolve();
+    if (err != BUTTON_OK) return err;
+
+    return Button_BankUpdate(&registry_bank);
+}
+
+button_bank_t* Button_RegistryBank(void) {
+    return (registry_resolve() == BUTTON_OK) ? &registry_bank : NULL;
+}
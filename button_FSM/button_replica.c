@@ -0,0 +1,264 @@
+#include    <stdbool.h>
+#include    <stdint.h>
+#include    <stddef.h>
+#include    "button_replica.h"
+
+static size_t encode_record(uint8_t* p, const button_bank_state_t* st, uint16_t gap, uint32_t now);
+static bool decode_records(const uint8_t* p, const uint8_t* end, uint16_t records, button_bank_t* bank, uint32_t now, bool apply);
+static unsigned int lowest_bit(uint32_t word);
+static size_t put_varint(uint8_t* p, uint32_t v);
+static bool get_varint(const uint8_t** p, const uint8_t* end, uint32_t* v);
+static void put_u16(uint8_t* p, uint16_t v);
+static void put_u32(uint8_t* p, uint32_t v);
+static uint16_t get_u16(const uint8_t* p);
+static uint32_t get_u32(const uint8_t* p);
+
+
+/* The first frame is always a snapshot */
+button_error_t ButtonReplica_EncoderInit(button_replica_encoder_t* enc) {
+    if (!enc) return BUTTON_ERR_INVALID_ARG;
+
+    *enc = (button_replica_encoder_t){ .sequence = 0, .resync = true, .pending = false };
+    return BUTTON_OK;
+}
+
+/* Requested when the standby (re)connects or reports a gap */
+button_error_t ButtonReplica_Resync(button_replica_encoder_t* enc) {
+    if (!enc) return BUTTON_ERR_INVALID_ARG;
+
+    enc->resync = true;
+    return BUTTON_OK;
+}
+
+/*
+ * Call from the sweeping thread after Button_BankUpdate. Writes one frame of
+ * at most @p cap bytes (BUTTON_REPLICA_MIN_FRAME at least); @p len is 0 when
+ * no button changed. Buttons that did not fit stay dirty and enc->pending is
+ * set: call again before the next sweep to send them in the same sweep.
+ */
+button_error_t ButtonReplica_Encode(button_replica_encoder_t* enc, button_bank_t* bank, uint8_t* buf, size_t cap, size_t* len) {
+    if (!enc || !bank || !buf || !len || cap < BUTTON_REPLICA_MIN_FRAME) return BUTTON_ERR_INVALID_ARG;
+    if (!bank->dirty || !bank->get_tick_func) return BUTTON_ERR_NOT_INIT;
+
+    uint16_t words = (uint16_t)BUTTON_BANK_MASK_WORDS(bank->count);
+    uint8_t flags = 0;
+    if (enc->resync) {
+        for (uint16_t w = 0; w < words; w++) {
+            uint16_t left = (uint16_t)(bank->count - w * 32u);
+            atomic_fetch_or_explicit(&bank->dirty[w], (left >= 32u) ? 0xFFFFFFFFu : ((1UL << left) - 1u), memory_order_relaxed);
+        }
+        enc->resync = false;
+        flags |= BUTTON_REPLICA_FLAG_SYNC;
+    }
+
+    if (cap > BUTTON_REPLICA_HEADER_SIZE + 0xFFFFu) cap = BUTTON_REPLICA_HEADER_SIZE + 0xFFFFu;
+    uint32_t now = bank->get_tick_func();
+    size_t pos = BUTTON_REPLICA_HEADER_SIZE;
+    uint16_t records = 0;
+    uint32_t next_index = 0;
+    bool more = false;
+
+    for (uint16_t w = 0; w < words && !more; w++) {
+        if (atomic_load_explicit(&bank->dirty[w], memory_order_relaxed) == 0) continue;
+        uint32_t word = (uint32_t)atomic_exchange_explicit(&bank->dirty[w], 0, memory_order_acquire);
+        while (word) {
+            if (cap - pos < BUTTON_REPLICA_MAX_RECORD) {
+                /* Out of room: the rest of this word goes back, later words were never drained */
+                atomic_fetch_or_explicit(&bank->dirty[w], word, memory_order_relaxed);
+                more = true;
+                break;
+            }
+            uint16_t i = (uint16_t)(w * 32u + lowest_bit(word));
+            word &= word - 1u;
+            pos += encode_record(&buf[pos], &bank->states[i], (uint16_t)(i - next_index), now);
+            next_index = i + 1u;
+            records++;
+        }
+    }
+
+    enc->pending = more;
+    if (records == 0 && !(flags & BUTTON_REPLICA_FLAG_SYNC)) {
+        *len = 0;
+        return BUTTON_OK;
+    }
+
+    buf[0] = 'B';
+    buf[1] = 'R';
+    buf[2] = BUTTON_REPLICA_VERSION;
+    buf[3] = (uint8_t)(flags | (more ? BUTTON_REPLICA_FLAG_MORE : 0u));
+    put_u32(&buf[4], enc->sequence++);
+    put_u16(&buf[8], (uint16_t)(pos - BUTTON_REPLICA_HEADER_SIZE));
+    put_u16(&buf[10], records);
+    *len = pos;
+    return BUTTON_OK;
+}
+
+button_error_t ButtonReplica_DecoderInit(button_replica_decoder_t* dec) {
+    if (!dec) return BUTTON_ERR_INVALID_ARG;
+
+    *dec = (button_replica_decoder_t){ .next_sequence = 0, .has_sequence = false, .chained = false, .synced = false,
+                                       .lost_frames = 0, .stale_frames = 0 };
+    return BUTTON_OK;
+}
+
+/* Total length of the frame starting with @p header (BUTTON_REPLICA_HEADER_SIZE bytes) */
+button_error_t ButtonReplica_FrameLength(const uint8_t* header, size_t* len) {
+    if (!header || !len) return BUTTON_ERR_INVALID_ARG;
+    if (header[0] != 'B' || header[1] != 'R' || header[2] != BUTTON_REPLICA_VERSION) return BUTTON_ERR_UNKNOWN;
+
+    *len = BUTTON_REPLICA_HEADER_SIZE + get_u16(&header[8]);
+    return BUTTON_OK;
+}
+
+/*
+ * Applies one frame to the standby bank. A malformed frame is rejected
+ * whole. Frames received after a gap are still applied, but dec->synced
+ * stays false until the next snapshot completes: ask the primary for one
+ * (ButtonReplica_Resync). A delta frame older than the last one applied
+ * (reordered or duplicated by the link) would roll states back: it is
+ * dropped and counted in dec->stale_frames. Call from the thread that sweeps
+ * the standby bank, or while it is not swept; no events are dispatched.
+ */
+button_error_t ButtonReplica_Apply(button_replica_decoder_t* dec, button_bank_t* bank, const uint8_t* frame, size_t len) {
+    size_t frame_len;
+    if (!dec || !bank || !frame || len < BUTTON_REPLICA_HEADER_SIZE) return BUTTON_ERR_INVALID_ARG;
+    if (!bank->states || !bank->get_tick_func) return BUTTON_ERR_NOT_INIT;
+    if (ButtonReplica_FrameLength(frame, &frame_len) != BUTTON_OK || len < frame_len) return BUTTON_ERR_UNKNOWN;
+
+    uint8_t flags = frame[3];
+    uint32_t sequence = get_u32(&frame[4]);
+    /* A snapshot is always taken: the primary restarts its sequence when it restarts */
+    if (!(flags & BUTTON_REPLICA_FLAG_SYNC) && dec->has_sequence && (int32_t)(sequence - dec->next_sequence) < 0) {
+        dec->stale_frames++;
+        return BUTTON_OK;
+    }
+
+    uint32_t now = bank->get_tick_func();
+    const uint8_t *end = frame + frame_len;
+    uint16_t records = get_u16(&frame[10]);
+    if (!decode_records(&frame[BUTTON_REPLICA_HEADER_SIZE], end, records, bank, now, false)) return BUTTON_ERR_UNKNOWN;
+    decode_records(&frame[BUTTON_REPLICA_HEADER_SIZE], end, records, bank, now, true);
+
+    if (flags & BUTTON_REPLICA_FLAG_SYNC) {
+        dec->chained = true;
+        dec->synced = false;
+    } else if (sequence != dec->next_sequence) {
+        if (dec->chained) dec->lost_frames += sequence - dec->next_sequence;
+        dec->chained = false;
+        dec->synced = false;
+    }
+    dec->next_sequence = sequence + 1u;
+    dec->has_sequence = true;
+    if (dec->chained && !(flags & BUTTON_REPLICA_FLAG_MORE)) dec->synced = true;
+    return BUTTON_OK;
+}
+
+static size_t encode_record(uint8_t* p, const button_bank_state_t* st, uint16_t gap, uint32_t now) {
+    size_t n = put_varint(p, gap);
+    p[n++] = st->state;
+    p[n++] = (uint8_t)atomic_load_explicit(&st->profile, memory_order_relaxed);
+    n += put_varint(&p[n], now - st->last_change_tick);
+
+    /* Press start, last HOLD and latches are only read in STATE_LONG_PRESSED */
+    if (st->state == STATE_LONG_PRESSED) {
+        n += put_varint(&p[n], now - st->press_start_tick);
+        n += put_varint(&p[n], now - st->last_hold_tick);
+        n += put_varint(&p[n], st->latches);
+        p[n++] = st->hold_stage;
+    }
+    return n;
+}
+
+/* Validation pass (apply == false) checks every record before any state is touched */
+static bool decode_records(const uint8_t* p, const uint8_t* end, uint16_t records, button_bank_t* bank, uint32_t now, bool apply) {
+    uint32_t index = 0;
+
+    for (uint16_t r = 0; r < records; r++) {
+        uint32_t gap, change_age, press_age, hold_age, latches = 0;
+        uint8_t hold_stage = 0;
+        if (!get_varint(&p, end, &gap) || end - p < 2) return false;
+        uint8_t state = p[0];
+        uint8_t profile = p[1];
+        p += 2;
+        if (!get_varint(&p, end, &change_age)) return false;
+        press_age = change_age;
+        hold_age = change_age;
+        if (state == STATE_LONG_PRESSED) {
+            if (!get_varint(&p, end, &press_age) || !get_varint(&p, end, &hold_age) || !get_varint(&p, end, &latches)) return false;
+            if (p >= end) return false;
+            hold_stage = *p++;
+        }
+
+        index += gap;
+        if (index >= bank->count || state > STATE_POWER_ON_HELD || profile >= bank->profile_count) return false;
+        if (hold_stage > BUTTON_BANK_MAX_STAGES) return false;
+
+        if (apply) {
+            button_bank_state_t *st = &bank->states[index];
+            st->state = state;
+            atomic_store_explicit(&st->profile, profile, memory_order_relaxed);
+            st->last_change_tick = now - change_age;
+            st->press_start_tick = now - press_age;
+            st->last_hold_tick = now - hold_age;
+            st->latches = latches;
+            st->hold_stage = hold_stage;
+        }
+        index++;
+    }
+    return p == end;
+}
+
+static unsigned int lowest_bit(uint32_t word) {
+#if defined(__GNUC__)
+    return (unsigned int)__builtin_ctz(word);
+#else
+    unsigned int bit = 0;
+    while (!(word & 1u)) { word >>= 1; bit++; }
+    return bit;
+#endif
+}
+
+static size_t put_varint(uint8_t* p, uint32_t v) {
+    size_t n = 0;
+    while (v >= 0x80u) {
+        p[n++] = (uint8_t)(v | 0x80u);
+        v >>= 7;
+    }
+    p[n++] = (uint8_t)v;
+    return n;
+}
+
+static bool get_varint(const uint8_t** p, const uint8_t* end, uint32_t* v) {
+    uint32_t value = 0;
+
+    for (unsigned int shift = 0; shift < 35u; shift += 7u) {
+        if (*p >= end) return false;
+        uint8_t byte = *(*p)++;
+        value |= (uint32_t)(byte & 0x7Fu) << shift;
+        if (!(byte & 0x80u)) {
+            *v = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void put_u16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static uint16_t get_u16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
@@ -1,16 +1,38 @@
 #include    <stdbool.h>
 #include    <stdint.h>
+#include    <stddef.h>
 #include    "button_static.h"
 
-static void handle_state_idle(button_t* button, bool is_pressed, uint32_t current_tick);
-static void handle_state_debounce(button_t* button, bool is_pressed, uint32_t current_tick);
-static void handle_state_pressed(button_t* button, bool is_pressed, uint32_t current_tick);
-static void handle_state_long(button_t* button, bool is_pressed, uint32_t current_tick);
+static void handle_state_idle(button_t* button, bool is_pressed, uint32_t current_tick, button_event_mask_t* events);
+static void handle_state_debounce(button_t* button, bool is_pressed, uint32_t current_tick, button_event_mask_t* events);
+static void handle_state_pressed(button_t* button, bool is_pressed, uint32_t current_tick, button_event_mask_t* events);
+static void handle_state_long(button_t* button, bool is_pressed, uint32_t current_tick, button_event_mask_t* events);
+static void handle_state_power_on(button_t* button, bool is_pressed, uint32_t current_tick, button_event_mask_t* events);
+#if BUTTON_FEATURE_STAGES
 static bool validate_stages(const button_stage_config_t *cfg, uint8_t count);
+#endif
+static void button_dispatch(button_t* button, button_event_t event, button_event_mask_t* events);
+static void button_dispatch_stage(button_t* button, button_event_t event, uint8_t stage, uint32_t threshold, button_event_mask_t* events);
+#if BUTTON_FEATURE_DISPATCH && BUTTON_FEATURE_STAGES
+static void publish_handler(button_t* button, button_callback_fn callback, button_stage_callback_fn stage_callback, void* context);
+#elif BUTTON_FEATURE_DISPATCH
+static void publish_handler(button_t* button, button_callback_fn callback, void* context);
+#endif
 
 
 button_error_t Button_Init(button_t* button, uint32_t gpio_num, button_active_level_t level, 
                 button_read_gpio_fn read_fn, get_tick_fn tick_fn) {
+    return Button_InitEx(button, gpio_num, level, read_fn, tick_fn, NULL);
+}
+
+/*
+ * With config->detect_held, a button already pressed at init (e.g. a recovery
+ * combo held through reset) skips debounce: it starts pressed, with its press
+ * back-dated by held_backdate_ticks, and the first Button_Update dispatches
+ * BUTTON_EVENT_POWER_ON_HELD instead of BUTTON_EVENT_PRESSED.
+ */
+button_error_t Button_InitEx(button_t* button, uint32_t gpio_num, button_active_level_t level,
+                button_read_gpio_fn read_fn, get_tick_fn tick_fn, const button_init_config_t* config) {
 
     if (!button || !read_fn || !tick_fn || level >= BUTTON_ACTIVE_MAX) return BUTTON_ERR_INVALID_ARG;
     
@@ -25,14 +47,34 @@ button_error_t Button_Init(button_t* button, uint32_t gpio_num, button_active_le
         .last_change_tick = now,
         .press_start_tick = now,
         .last_hold_tick = now,
-        .callback = NULL,        
-        .context = NULL,
-        .stages = { .configs = NULL, .latches = NULL, .count = 0 }
+#if BUTTON_FEATURE_STAGES && BUTTON_FEATURE_HOLD
+        .hold_interval = BUTTON_HOLD_TICKS,
+#endif
+        .last_event = BUTTON_EVENT_NONE,
+#if BUTTON_FEATURE_DISPATCH
+        .handler_seq = 0,
+#endif
+#if BUTTON_FEATURE_STAGES
+        .stages = { .configs = NULL, .latches = NULL, .count = 0 },
+#endif
     };
 
+    if (config && config->detect_held) {
+        bool pin_state = (bool)read_fn(gpio_num);
+        bool is_pressed = (level == BUTTON_ACTIVE_LOW) ? (pin_state == 0) : (pin_state != 0);
+        if (is_pressed) {
+            uint32_t since = now - config->held_backdate_ticks;
+            button->last_state = STATE_POWER_ON_HELD;
+            button->last_change_tick = since;
+            button->press_start_tick = since;
+            button->last_hold_tick = since;
+        }
+    }
+
     return BUTTON_OK; 
 }
 
+#if BUTTON_FEATURE_STAGES
 button_error_t Button_ConfigStages(button_t* button, const button_stage_config_t* configs, bool* latches, uint8_t count) {
     if (!button || !configs || !latches || count == 0) return BUTTON_ERR_INVALID_ARG;
     if (!validate_stages(configs, count)) return BUTTON_ERR_INVALID_STAGES;
@@ -41,117 +83,158 @@ button_error_t Button_ConfigStages(button_t* button, const button_stage_config_t
     button->stages.count = count;
     return BUTTON_OK;
 }
+#endif
 
 button_error_t Button_Update(button_t* button) {
+    return Button_UpdateEx(button, NULL);
+}
+
+/*
+ * Button_Update that also reports what it dispatched: @p events (optional)
+ * receives the set of events of this call, 0 on a quiet update, so the
+ * caller can skip refresh and logging work.
+ */
+button_error_t Button_UpdateEx(button_t* button, button_event_mask_t* events) {
     if (!button || !button->read_pin_func || !button->get_tick_func) return BUTTON_ERR_INVALID_ARG;
 
+    button_event_mask_t dispatched = 0;
     bool pin_state = (bool)button->read_pin_func(button->gpio_num);
     bool is_pressed = (button->active_level == BUTTON_ACTIVE_LOW) ? (pin_state == 0) : (pin_state != 0);
     uint32_t current_tick = button->get_tick_func();    
 
     switch (button->last_state) {
         case STATE_IDLE:
-             handle_state_idle(button, is_pressed, current_tick);    
+             handle_state_idle(button, is_pressed, current_tick, &dispatched);    
              break;
         case STATE_DEBOUNCE: 
-            handle_state_debounce(button, is_pressed, current_tick); 
+            handle_state_debounce(button, is_pressed, current_tick, &dispatched); 
             break;
         case STATE_PRESSED:  
-            handle_state_pressed(button, is_pressed, current_tick);  
+            handle_state_pressed(button, is_pressed, current_tick, &dispatched);  
             break;
         case STATE_LONG_PRESSED:     
-            handle_state_long(button, is_pressed, current_tick);     
+            handle_state_long(button, is_pressed, current_tick, &dispatched);     
+            break;
+        case STATE_POWER_ON_HELD:
+            handle_state_power_on(button, is_pressed, current_tick, &dispatched);
             break;
         default:             
             button->last_state = STATE_IDLE;                
             break;
     }
+    if (events) *events = dispatched;
     return BUTTON_OK;
 }
 
-static void handle_state_idle(button_t* button, bool is_pressed, uint32_t current_tick) {
+static void handle_state_idle(button_t* button, bool is_pressed, uint32_t current_tick, button_event_mask_t* events) {
+    (void)events;   /* Entering debounce dispatches nothing */
     if (is_pressed) {
         button->last_state = STATE_DEBOUNCE;
         button->last_change_tick = current_tick;
     }
 }
 
-static void handle_state_debounce(button_t* button, bool is_pressed, uint32_t current_tick) {
+static void handle_state_debounce(button_t* button, bool is_pressed, uint32_t current_tick, button_event_mask_t* events) {
     uint32_t diff = current_tick - button->last_change_tick;
     if (diff >= BUTTON_DEBOUNCE_TICKS) {
         if (is_pressed) {
             button->last_state = STATE_PRESSED;
             button->last_change_tick = current_tick;
-            if (button->callback) {
-                button->callback(BUTTON_EVENT_PRESSED, button->context);
-            }
+            button_dispatch(button, BUTTON_EVENT_PRESSED, events);
         } else {
             button->last_state = STATE_IDLE;
         }
     }
 }
 
-static void handle_state_pressed(button_t* button, bool is_pressed, uint32_t current_tick) {
+static void handle_state_pressed(button_t* button, bool is_pressed, uint32_t current_tick, button_event_mask_t* events) {
     uint32_t diff = current_tick - button->last_change_tick;
 
     if (!is_pressed) {
         button->last_state = STATE_IDLE;
-        if (button->callback != NULL) {
-            button->callback(BUTTON_EVENT_RELEASED, button->context);
-        }
+        button_dispatch(button, BUTTON_EVENT_RELEASED, events);
     } 
     else if (diff >= BUTTON_LONG_PRESS_TICKS) {
         button->last_state = STATE_LONG_PRESSED;
         button->last_change_tick = current_tick;
         button->press_start_tick = current_tick;
         button->last_hold_tick   = current_tick;
+#if BUTTON_FEATURE_STAGES && BUTTON_FEATURE_HOLD
+        button->hold_interval    = BUTTON_HOLD_TICKS;
+#endif
 
-        if (button->callback != NULL) {
-            button->callback(BUTTON_EVENT_LONG_PRESSED, button->context);
-        }
+        button_dispatch(button, BUTTON_EVENT_LONG_PRESSED, events);
     }
     else {
         
     }
 }
 
-static void handle_state_long(button_t* button, bool is_pressed, uint32_t current_tick) {
+static void handle_state_long(button_t* button, bool is_pressed, uint32_t current_tick, button_event_mask_t* events) {
 
     if (!is_pressed) {
         button->last_state = STATE_IDLE;
         /* Clear RAM reset the cycle*/
+#if BUTTON_FEATURE_STAGES
         if (button->stages.latches != NULL) {
             for (uint8_t i = 0; i < button->stages.count; i++) {
                 button->stages.latches[i] = false;
             }
         }
+#endif
+        button->is_long_pressed_triggered = false;
   
-        if (button->callback) {
-            button->callback(BUTTON_EVENT_RELEASED, button->context);
-        }
+        button_dispatch(button, BUTTON_EVENT_RELEASED, events);
         return;
     }
 
 
 
     uint32_t total_pressed_time = current_tick - button->press_start_tick;
+#if BUTTON_FEATURE_SUPER_LONG
+    /* Same as a one-stage table, fired ahead of any configured stages */
+    if (total_pressed_time >= BUTTON_SUPER_LONG_PRESS_TICKS && !button->is_long_pressed_triggered) {
+        button->is_long_pressed_triggered = true;
+        button_dispatch(button, BUTTON_EVENT_SUPER_LONG_PRESSED, events);
+    }
+#endif
+#if BUTTON_FEATURE_STAGES
     if(button->stages.configs != NULL && button->stages.latches != NULL) {
         for(uint8_t i = 0; i < button->stages.count; i++) {
             if (total_pressed_time >= button->stages.configs[i].threshold && !button->stages.latches[i]) {
                 button->stages.latches[i] = true; 
-                if (button->callback) button->callback(button->stages.configs[i].event, button->context);
+#if BUTTON_FEATURE_HOLD
+                /* Only the deadline moves: the next HOLD is due one new interval after the last one */
+                if (button->stages.configs[i].hold_ticks != 0) {
+                    button->hold_interval = button->stages.configs[i].hold_ticks;
+                }
+#endif
+                button_dispatch_stage(button, button->stages.configs[i].event, i, button->stages.configs[i].threshold, events);
             }
         }
     }
+#endif
 
+#if BUTTON_FEATURE_HOLD
+#if BUTTON_FEATURE_STAGES
+    uint32_t hold_interval = button->hold_interval;
+#else
+    uint32_t hold_interval = BUTTON_HOLD_TICKS;
+#endif
      if (total_pressed_time >= BUTTON_LONG_PRESS_TICKS) {
-        if ((current_tick - button->last_hold_tick) >= BUTTON_HOLD_TICKS) {
+        if (hold_interval != BUTTON_HOLD_OFF && (current_tick - button->last_hold_tick) >= hold_interval) {
             button->last_hold_tick = current_tick; // Cập nhật mốc mới
-            if (button->callback) {
-                button->callback(BUTTON_EVENT_HOLD, button->context);
-            }
+            button_dispatch(button, BUTTON_EVENT_HOLD, events);
         }    
     }
+#endif
+    (void)total_pressed_time;
+}
+
+static void handle_state_power_on(button_t* button, bool is_pressed, uint32_t current_tick, button_event_mask_t* events) {
+    button->last_state = STATE_PRESSED;
+    button_dispatch(button, BUTTON_EVENT_POWER_ON_HELD, events);
+    handle_state_pressed(button, is_pressed, current_tick, events);
 }
 
 button_error_t Button_Deinit(button_t* button) {
@@ -161,28 +244,131 @@ button_error_t Button_Deinit(button_t* button) {
     return BUTTON_OK;
 }
 
+#if BUTTON_FEATURE_DISPATCH
 button_error_t Button_RegisterHandler(button_t* button, button_callback_fn callback, void* context)
 {
+#if BUTTON_FEATURE_STAGES
+    return Button_RegisterHandlerEx(button, callback, NULL, context);
+#else
+    if (!button) return BUTTON_ERR_INVALID_ARG;
+
+    publish_handler(button, callback, context);
+    return BUTTON_OK;
+#endif
+}
+
+#if BUTTON_FEATURE_STAGES
+
+/*
+ * Like Button_RegisterHandler; stage events go to @p stage_callback, with the
+ * index of the stage and its threshold, when it is set. Other events, and
+ * stage events without @p stage_callback, go to @p callback.
+ */
+button_error_t Button_RegisterHandlerEx(button_t* button, button_callback_fn callback, button_stage_callback_fn stage_callback, void* context) {
     if (!button) return BUTTON_ERR_INVALID_ARG;
 
-    button->callback = callback;
-    button->context = context;
+    publish_handler(button, callback, stage_callback, context);
     return BUTTON_OK;
 }
+#endif
 
+/*
+ * A dispatch already running on another thread may still call the old handler
+ * with its context after this returns (or after a registration that replaces
+ * it): button_t keeps no update count to wait on. Unregister from the thread
+ * that calls Button_Update, or keep the context alive as long as the button is
+ * updated. A bank can wait instead, see Button_BankHandlerGrace.
+ */
 button_error_t Button_UnregisterHandler(button_t* button){
     if (!button) return BUTTON_ERR_INVALID_ARG;
 
-    button->callback = NULL;
-    button->context = NULL;
+#if BUTTON_FEATURE_STAGES
+    publish_handler(button, NULL, NULL, NULL);
+#else
+    publish_handler(button, NULL, NULL);
+#endif
     return BUTTON_OK;
 }
+#endif
 
+#if BUTTON_FEATURE_STAGES
 static bool validate_stages(const button_stage_config_t *cfg, uint8_t count) {
     if (!cfg || count == 0) return false;
     if (cfg[0].threshold == 0) return false;
-    for (uint8_t i = 1; i < count; i++) {
-        if (cfg[i].threshold <= cfg[i - 1].threshold) return false;
+    for (uint8_t i = 0; i < count; i++) {
+        /* The event is dispatched as is and sets its bit in the event mask */
+        if (cfg[i].event == BUTTON_EVENT_NONE || cfg[i].event >= BUTTON_EVENT_MAX) return false;
+        if (i > 0 && cfg[i].threshold <= cfg[i - 1].threshold) return false;
     }
     return true;
-}
\ No newline at end of file
+}
+#endif
+
+static void button_dispatch(button_t* button, button_event_t event, button_event_mask_t* events) {
+    button_dispatch_stage(button, event, BUTTON_STAGE_NONE, 0, events);
+}
+
+/*
+ * Lock-free read of the live handler set (seqlock over two slots).
+ * The writer only touches the slot that is not live, so a retry is needed
+ * only when two registrations overlap one read.
+ */
+static void button_dispatch_stage(button_t* button, button_event_t event, uint8_t stage, uint32_t threshold, button_event_mask_t* events) {
+    button->last_event = event;
+    *events |= BUTTON_EVENT_BIT(event);
+
+#if BUTTON_FEATURE_DISPATCH
+    button_callback_fn callback;
+#if BUTTON_FEATURE_STAGES
+    button_stage_callback_fn stage_callback;
+#endif
+    void* context;
+    unsigned int seq;
+
+    do {
+        seq = atomic_load_explicit(&button->handler_seq, memory_order_acquire);
+        button_handler_t *h = &button->handlers[seq & 1u];
+        callback = atomic_load_explicit(&h->callback, memory_order_relaxed);
+#if BUTTON_FEATURE_STAGES
+        stage_callback = atomic_load_explicit(&h->stage_callback, memory_order_relaxed);
+#endif
+        context = atomic_load_explicit(&h->context, memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+    } while (seq != atomic_load_explicit(&button->handler_seq, memory_order_relaxed));
+
+#if BUTTON_FEATURE_STAGES
+    if (stage != BUTTON_STAGE_NONE && stage_callback) {
+        stage_callback(event, stage, threshold, context);
+    } else if (callback) {
+        callback(event, context);
+    }
+#else
+    if (callback) {
+        callback(event, context);
+    }
+#endif
+#endif
+    (void)stage;
+    (void)threshold;
+}
+
+#if BUTTON_FEATURE_DISPATCH
+/* Single writer: handler changes for one button must not race each other */
+#if BUTTON_FEATURE_STAGES
+static void publish_handler(button_t* button, button_callback_fn callback, button_stage_callback_fn stage_callback, void* context) {
+#else
+static void publish_handler(button_t* button, button_callback_fn callback, void* context) {
+#endif
+    unsigned int seq = atomic_load_explicit(&button->handler_seq, memory_order_relaxed);
+    button_handler_t *h = &button->handlers[(seq + 1u) & 1u];
+
+    /* Readers that see these stores must also see the previous publish */
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&h->callback, callback, memory_order_relaxed);
+    atomic_store_explicit(&h->context, context, memory_order_relaxed);
+#if BUTTON_FEATURE_STAGES
+    atomic_store_explicit(&h->stage_callback, stage_callback, memory_order_relaxed);
+#endif
+    atomic_store_explicit(&button->handler_seq, seq + 1u, memory_order_release);
+}
+#endif
@@ -0,0 +1,249 @@
+/**
+ * @file    button_bank.h
+ * @author  datngyB
+ * @brief   Bank of buttons sharing HAL hooks, timing profiles and one sweep per scan.
+ * @version 0.1.0
+ * @date    2026-10-18
+ * * @copyright Copyright (c) 2026
+ *
+ * A bank splits every button into a const entry (Flash) and a small dynamic
+ * state (RAM). Timing and stage configuration live in a shared profile table;
+ * per-button RAM is the FSM state plus a one-byte profile index, so hundreds
+ * of buttons sharing a handful of profiles cost no configuration pointers.
+ * The FSM emits exactly the same events as button_static.c for the same profile.
+ *
+ * The profile table can be replaced while another thread sweeps the bank
+ * (Button_BankPublishProfiles). Each sweep loads the table pointer once, so a
+ * sweep sees either the old or the new table, never a mix. The old table may
+ * be reused or freed once Button_BankGraceElapsed reports that every sweep
+ * that could still hold it has finished. Only one thread may sweep a bank.
+ * Handlers work the same way: after Button_BankUnregisterHandler (or a
+ * registration that replaces a handler), take Button_BankHandlerGrace; once it
+ * has elapsed, no dispatch still calls the old handler or uses its context.
+ *
+ * Optional enable masks (Button_BankConfigMasks) let a sweep skip disabled
+ * buttons a 32-button word at a time. A disabled button keeps its entry; the
+ * next sweep releases it (BUTTON_EVENT_RELEASED if a press was reported) and
+ * it restarts from STATE_IDLE when enabled again. Button_BankSuspend pauses the
+ * whole bank; on resume every FSM timer is shifted by the pause length, so
+ * debounce and long-press countdowns continue where they stopped.
+ *
+ * Scan groups (Button_BankConfigGroups) give sets of buttons their own
+ * sampling period: a sweep samples only the groups that are due, so the bank
+ * can be swept at the rate of its fastest group (e.g. 1 kHz limit switches)
+ * while menu buttons are read at 50 Hz.
+ *
+ * Keymaps translate (button, event) into application action ids per UI mode.
+ * The dispatcher looks the action up in the current keymap and passes it to
+ * the action handler; switching modes is one pointer store
+ * (Button_BankSetKeymap), whatever the number of buttons.
+ *
+ * With BUTTON_FEATURE_DISPATCH=0 the bank has no handlers at all (entry
+ * callbacks, bank handler, keymap actions): events are reported only by
+ * Button_BankUpdateEx, the live state page and the latency counters.
+ *
+ * A dirty mask (Button_BankConfigDirty) records which buttons changed FSM
+ * state since it was last drained, so a standby controller can be kept in
+ * step by sending only those states (see button_replica.h).
+ *
+ * Latency instrumentation (Button_BankConfigLatency) measures, per button,
+ * the time from the physical edge to the dispatch of PRESSED and RELEASED
+ * (see button_latency.h).
+ *
+ * A live state page (Button_BankConfigMonitor) mirrors every button's state,
+ * last event and press start for external monitors that sample it at their
+ * own rate (see button_monitor.h).
+ */
+
+#ifndef BUTTON_BANK_H
+#define BUTTON_BANK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "button_static.h"
+#include "button_latency.h"
+#include "button_monitor.h"
+
+#if BUTTON_FEATURE_SUPER_LONG
+#define BUTTON_BANK_MAX_STAGES      31  /* Stage latches are kept as a bitmask; bit 31 latches the built-in super-long press */
+#define BUTTON_BANK_SUPER_LONG_LATCH (1UL << 31)
+#else
+#define BUTTON_BANK_MAX_STAGES      32  /* Stage latches are kept as a bitmask */
+#endif
+#define BUTTON_BANK_MAX_GROUPS      8   /* Scan groups per bank */
+
+/* Timing and multi-stage configuration shared by many buttons (Flash) */
+typedef struct {
+    uint32_t debounce_ticks;                /**< Same meaning as BUTTON_DEBOUNCE_TICKS */
+    uint32_t long_press_ticks;              /**< Same meaning as BUTTON_LONG_PRESS_TICKS */
+    uint32_t hold_ticks;                    /**< Same meaning as BUTTON_HOLD_TICKS */
+    const button_stage_config_t *stages;    /**< Optional multi-stage table, thresholds strictly increasing, events in range */
+    uint8_t stage_count;
+} button_profile_t;
+
+/*
+ * Profile in milliseconds (Flash), stage thresholds included. Converted to a
+ * button_profile_t once, at init, for the tick rate of the board.
+ */
+typedef struct {
+    uint32_t debounce_ms;
+    uint32_t long_press_ms;
+    uint32_t hold_ms;
+    const button_stage_config_t *stages;    /**< Thresholds and HOLD intervals in milliseconds */
+    uint8_t stage_count;
+} button_profile_ms_t;
+
+/* Profile with the compile-time default timings */
+#define BUTTON_PROFILE_DEFAULT(stage_table, n) \
+    { BUTTON_DEBOUNCE_TICKS, BUTTON_LONG_PRESS_TICKS, BUTTON_HOLD_TICKS, (stage_table), (n) }
+
+/* One button of the bank (Flash) */
+typedef struct {
+    uint32_t gpio_num;                  /**< Passed to the bank read hook */
+    button_active_level_t active_level; /**< Electrical level of the 'Pressed' state */
+    uint8_t profile;                    /**< Initial index into the bank profile table */
+    uint8_t group;                      /**< Scan group, used once Button_BankConfigGroups is called */
+#if BUTTON_FEATURE_DISPATCH
+    button_callback_fn callback;        /**< Optional per-button handler, NULL when only the bank handler is used */
+    void* context;                      /**< Passed back to @c callback */
+#endif
+} button_bank_entry_t;
+
+/* Dynamic FSM state of one button (RAM) */
+typedef struct {
+    uint32_t last_change_tick;  /**< Timestamp of the last state transition */
+    uint32_t press_start_tick;  /**< Timestamp of the long-press entry, base of stage thresholds */
+    uint32_t last_hold_tick;    /**< Timestamp of the last dispatched HOLD event */
+    uint32_t latches;           /**< Bit i set once stage i fired during the current press */
+    uint8_t state;              /**< button_state_t */
+    atomic_uint_least8_t profile; /**< Index into the bank profile table; starts as the entry's profile */
+    uint8_t hold_stage;         /**< 1 + last stage that set a HOLD interval; 0 uses the profile's hold_ticks */
+} button_bank_state_t;
+
+#if BUTTON_FEATURE_DISPATCH
+typedef void (*button_bank_callback_fn)(uint16_t index, button_event_t event, void* context);
+#if BUTTON_FEATURE_STAGES
+typedef void (*button_bank_stage_callback_fn)(uint16_t index, button_event_t event, uint8_t stage, uint32_t threshold, void* context);
+#endif
+
+/* Bank-level handler set, read atomically like button_handler_t */
+typedef struct {
+    _Atomic(button_bank_callback_fn) callback;
+    _Atomic(void*) context;
+#if BUTTON_FEATURE_STAGES
+    _Atomic(button_bank_stage_callback_fn) stage_callback;  /**< Optional; takes stage events instead of @c callback */
+#endif
+} button_bank_handler_t;
+#endif
+
+/* Sweep sequence number after which a retired profile table is no longer referenced */
+typedef uint32_t button_grace_t;
+
+/* One word of an enable or restart mask: bit (i % 32) of word (i / 32) is button i */
+typedef atomic_uint_least32_t button_bank_mask_t;
+
+#define BUTTON_BANK_MASK_WORDS(count)   (((count) + 31u) / 32u)
+
+#if BUTTON_FEATURE_DISPATCH
+/* Action id of a keymap slot; BUTTON_ACTION_NONE is not dispatched */
+typedef uint16_t button_action_t;
+#define BUTTON_ACTION_NONE          0u
+
+/* Keymap of one UI mode (Flash): actions[index * BUTTON_EVENT_MAX + event] */
+typedef struct {
+    const button_action_t *actions;
+    uint16_t count;             /**< Buttons covered, at least the bank count */
+} button_keymap_t;
+
+typedef void (*button_action_fn)(uint16_t index, button_action_t action, void* context);
+#endif
+
+/* Sampling period of one scan group (Flash) */
+typedef struct {
+    uint32_t period_ticks;      /**< 0: sampled on every sweep */
+} button_scan_group_t;
+
+typedef struct {
+    const button_bank_entry_t *entries;
+    button_bank_state_t *states;
+    _Atomic(const button_profile_t *) profiles; /**< Published table, loaded once per sweep */
+    uint16_t count;
+    uint8_t profile_count;                      /**< Size of the published table (writer side only) */
+    atomic_uint_fast32_t sweep_seq;             /**< Incremented at sweep start and end: odd while sweeping */
+
+    button_bank_mask_t *enabled;        /**< Optional; NULL sweeps every button */
+    button_bank_mask_t *restart;        /**< Buttons to reset to IDLE on the next sweep (set by enable and disable) */
+    atomic_bool suspended;              /**< Requested by Button_BankSuspend / Button_BankResume */
+    bool paused;                        /**< Sweeper side: the bank is currently paused */
+    uint32_t pause_tick;                /**< Sweeper side: tick of the first paused sweep */
+
+    const button_scan_group_t *groups;  /**< Optional; NULL samples every button on every sweep */
+    const uint32_t *group_members;      /**< group_count masks of BUTTON_BANK_MASK_WORDS(count) words */
+    uint8_t group_count;
+    uint32_t group_due[BUTTON_BANK_MAX_GROUPS]; /**< Sweeper side: next sampling tick of each group */
+
+#if BUTTON_FEATURE_DISPATCH
+    _Atomic(const button_keymap_t *) keymap;    /**< Current mode; NULL dispatches no actions */
+    button_action_fn action_func;               /**< Set once before sweeping */
+    void* action_context;
+#endif
+
+    button_bank_mask_t *dirty;          /**< Optional; buttons whose state changed since the mask was drained */
+    button_latency_t *latency;          /**< Optional; one per button, written by the sweeping thread */
+    button_monitor_page_t *monitor;     /**< Optional; live state page, written by the sweeping thread */
+    bool monitor_open;                  /**< Sweeper side: the current sweep holds the page sequence odd */
+
+    uint32_t sweep_tick;                /**< Sweeper side: tick read by the current sweep */
+    button_event_mask_t sweep_events;   /**< Sweeper side: events dispatched by the current sweep */
+    uint32_t sweep_event_count;
+
+    button_read_gpio_fn read_pin_func;
+    get_tick_fn get_tick_func;
+
+#if BUTTON_FEATURE_DISPATCH
+    button_bank_handler_t handlers[2];  /**< Double-buffered bank handler; receives the entry index with every event */
+    atomic_uint handler_seq;            /**< Bumped by every (un)registration; bit 0 selects the live handler */
+#endif
+} button_bank_t;
+
+// API
+button_error_t Button_BankProfilesFromMs(button_profile_t* profiles, button_stage_config_t* stage_buf, uint16_t stage_buf_len,
+                                         const button_profile_ms_t* ms_profiles, uint8_t count, uint32_t tick_hz);
+button_error_t Button_BankInit(button_bank_t* bank, const button_bank_entry_t* entries, button_bank_state_t* states, uint16_t count,
+                               const button_profile_t* profiles, uint8_t profile_count,
+                               button_read_gpio_fn read_fn, get_tick_fn tick_fn);
+button_error_t Button_BankUpdate(button_bank_t* bank);
+button_error_t Button_BankUpdateEx(button_bank_t* bank, button_event_mask_t* events, uint32_t* count);
+button_error_t Button_BankPublishProfiles(button_bank_t* bank, const button_profile_t* profiles, uint8_t profile_count, button_grace_t* grace);
+bool Button_BankGraceElapsed(const button_bank_t* bank, button_grace_t grace);
+button_error_t Button_BankDetectHeld(button_bank_t* bank, uint32_t backdate_ticks);
+button_error_t Button_BankSetProfile(button_bank_t* bank, uint16_t index, uint8_t profile);
+button_error_t Button_BankConfigMasks(button_bank_t* bank, button_bank_mask_t* enabled, button_bank_mask_t* restart);
+button_error_t Button_BankEnable(button_bank_t* bank, uint16_t index);
+button_error_t Button_BankDisable(button_bank_t* bank, uint16_t index);
+bool Button_BankIsEnabled(const button_bank_t* bank, uint16_t index);
+button_error_t Button_BankConfigGroups(button_bank_t* bank, const button_scan_group_t* groups, uint8_t group_count, uint32_t* members);
+button_error_t Button_BankNextDue(const button_bank_t* bank, uint32_t* tick);
+#if BUTTON_FEATURE_DISPATCH
+button_error_t Button_BankConfigActions(button_bank_t* bank, button_action_fn action_fn, void* context);
+button_error_t Button_BankSetKeymap(button_bank_t* bank, const button_keymap_t* keymap, button_grace_t* grace);
+#endif
+button_error_t Button_BankConfigDirty(button_bank_t* bank, button_bank_mask_t* dirty);
+button_error_t Button_BankConfigLatency(button_bank_t* bank, button_latency_t* latency);
+button_error_t Button_BankConfigMonitor(button_bank_t* bank, button_monitor_page_t* page);
+button_error_t Button_BankMarkEdge(button_bank_t* bank, uint16_t index, uint32_t tick);
+button_error_t Button_BankSuspend(button_bank_t* bank);
+button_error_t Button_BankResume(button_bank_t* bank);
+#if BUTTON_FEATURE_DISPATCH
+button_error_t Button_BankRegisterHandler(button_bank_t* bank, button_bank_callback_fn callback, void* context);
+#if BUTTON_FEATURE_STAGES
+button_error_t Button_BankRegisterHandlerEx(button_bank_t* bank, button_bank_callback_fn callback,
+                                            button_bank_stage_callback_fn stage_callback, void* context);
+#endif
+button_error_t Button_BankUnregisterHandler(button_bank_t* bank);
+button_error_t Button_BankHandlerGrace(const button_bank_t* bank, button_grace_t* grace);
+#endif
+button_error_t Button_BankDeinit(button_bank_t* bank);
+
+#endif // BUTTON_BANK_H
@@ -0,0 +1,80 @@
+/**
+ * @file    button_hid.h
+ * @author  datngyB
+ * @brief   USB HID keyboard reports (boot protocol and NKRO) built from bank events.
+ * @version 0.1.0
+ * @date    2026-10-18
+ * * @copyright Copyright (c) 2026
+ *
+ * Each bank button maps to one keyboard-page usage (Flash table). The builder
+ * keeps the pressed set and both reports up to date on every PRESSED and
+ * RELEASED, so a key change costs a bit flip and at most one small slot
+ * update, never a scan of the bank. A report is handed out only when the
+ * active one changed since the last one taken.
+ *
+ * Boot report (8 bytes): modifiers, reserved, 6 key slots in press order.
+ * With more than 6 non-modifier keys down, the slots all read
+ * BUTTON_HID_ERROR_ROLLOVER as the HID spec asks; when keys are released back
+ * to 6, the slots are refilled from the pressed set (ascending usage).
+ *
+ * NKRO report (BUTTON_HID_NKRO_REPORT_SIZE bytes): modifiers, reserved, then
+ * one bit per usage 0x00..0xDF. Matching report descriptor items:
+ * Usage Minimum 0x00, Usage Maximum 0xDF, Report Size 1, Report Count 224,
+ * Input (Data, Variable, Absolute).
+ *
+ * Usage:
+ *     ButtonHid_Init(&hid, usages, bank.count);
+ *     Button_BankRegisterHandler(&bank, ButtonHid_OnEvent, &hid);
+ *     for (;;) { Button_BankUpdate(&bank); if (ButtonHid_TakeReport(&hid, buf, sizeof(buf), &len) == BUTTON_OK && len) usb_send(buf, len); }
+ */
+
+#ifndef BUTTON_HID_H
+#define BUTTON_HID_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include "button_static.h"
+
+#define BUTTON_HID_USAGE_NONE       0x00u   /* Button is not a key */
+#define BUTTON_HID_ERROR_ROLLOVER   0x01u
+#define BUTTON_HID_MODIFIER_FIRST   0xE0u   /* Left Control; 0xE0..0xE7 go to the modifier byte */
+#define BUTTON_HID_MODIFIER_LAST    0xE7u   /* Right GUI */
+
+#define BUTTON_HID_BOOT_KEYS        6
+#define BUTTON_HID_BOOT_REPORT_SIZE 8u
+#define BUTTON_HID_NKRO_USAGES      224u    /* 0x00..0xDF: every non-modifier usage */
+#define BUTTON_HID_NKRO_REPORT_SIZE (2u + BUTTON_HID_NKRO_USAGES / 8u)
+#define BUTTON_HID_PRESSED_WORDS    (BUTTON_HID_NKRO_USAGES / 32u)
+
+/* Values of the HID SET_PROTOCOL request */
+typedef enum {
+    BUTTON_HID_PROTOCOL_BOOT = 0,
+    BUTTON_HID_PROTOCOL_NKRO = 1,   /* Report protocol */
+} button_hid_protocol_t;
+
+typedef struct {
+    const uint8_t *usages;          /**< Keyboard-page usage per bank index (Flash); BUTTON_HID_USAGE_NONE for non-keys */
+    uint16_t count;
+
+    uint32_t pressed[BUTTON_HID_PRESSED_WORDS]; /**< Non-modifier usages down: bit (u % 32) of word (u / 32) */
+    uint8_t key_count;              /**< Non-modifier usages down; above BUTTON_HID_BOOT_KEYS the boot report rolls over */
+    uint8_t boot_keys;              /**< Boot slots in use while not rolled over */
+    uint8_t boot[BUTTON_HID_BOOT_REPORT_SIZE];
+    uint8_t nkro[BUTTON_HID_NKRO_REPORT_SIZE];
+    bool boot_changed;              /**< Boot report differs from the last one taken */
+    bool nkro_changed;
+
+    atomic_uint_least8_t protocol;  /**< Requested by the host (ButtonHid_SetProtocol) */
+    uint8_t sent_protocol;          /**< Protocol of the last report taken */
+} button_hid_t;
+
+// API
+button_error_t ButtonHid_Init(button_hid_t* hid, const uint8_t* usages, uint16_t count);
+button_error_t ButtonHid_SetProtocol(button_hid_t* hid, button_hid_protocol_t protocol);
+button_error_t ButtonHid_SetKey(button_hid_t* hid, uint16_t index, bool pressed);
+void ButtonHid_OnEvent(uint16_t index, button_event_t event, void* context);
+button_error_t ButtonHid_TakeReport(button_hid_t* hid, uint8_t* buf, size_t cap, size_t* len);
+
+#endif // BUTTON_HID_H
@@ -0,0 +1,88 @@
+/**
+ * @file    button_input.h
+ * @author  datngyB
+ * @brief   Batched reader of button input descriptors (Linux hosts): io_uring with an epoll fallback.
+ * @version 0.1.0
+ * @date    2026-10-18
+ * * @copyright Copyright (c) 2026
+ *
+ * Each input is a file descriptor (device node, pipe, regular file) whose
+ * data carries the level of one button. ButtonInput_Poll keeps one read in
+ * flight per input and, with io_uring, submits new reads and collects
+ * completions for every input in a single io_uring_enter, instead of one
+ * read syscall per descriptor per scan. Where io_uring is not available
+ * (old kernel, seccomp, io_uring_disabled), epoll is used: one epoll_wait
+ * plus one read per ready descriptor.
+ *
+ * The level of input i is what the bank read hook returns for gpio_num i:
+ *     static bool read_pin(uint32_t gpio) { return ButtonInput_Level(&input, gpio); }
+ *     for (;;) { ButtonInput_Poll(&input, NULL); Button_BankUpdate(&bank); wait_scan(); }
+ *
+ * By default the last non-blank byte of a read sets the level ('0' or 0 is
+ * low, anything else high), so "echo 1 > fifo" works; ButtonInput_SetDecoder
+ * installs another format (e.g. struct input_event). Poll and the read hook
+ * run on the sweeping thread.
+ *
+ * The epoll backend sets O_NONBLOCK on the descriptors it watches. That flag
+ * belongs to the open file description, so dup'ed descriptors see it too
+ * until ButtonInput_Close restores the original flags.
+ */
+
+#ifndef BUTTON_INPUT_H
+#define BUTTON_INPUT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "button_static.h"
+
+#define BUTTON_INPUT_MAX            64      /* Inputs per reader */
+#ifndef BUTTON_INPUT_BUF_SIZE
+#define BUTTON_INPUT_BUF_SIZE       64      /* Bytes per read; a read may carry several level changes */
+#endif
+
+typedef enum {
+    BUTTON_INPUT_BACKEND_NONE = 0,
+    BUTTON_INPUT_BACKEND_IO_URING,
+    BUTTON_INPUT_BACKEND_EPOLL
+} button_input_backend_t;
+
+/* Returns the level after @p data, given the level before it */
+typedef bool (*button_input_decode_fn)(const uint8_t* data, size_t len, bool level);
+
+typedef struct {
+    button_input_backend_t backend;
+    int fds[BUTTON_INPUT_MAX];
+    uint16_t count;
+    bool levels[BUTTON_INPUT_MAX];
+    bool in_flight[BUTTON_INPUT_MAX];   /**< io_uring: a read is queued for this input */
+    bool is_file[BUTTON_INPUT_MAX];     /**< Regular file: no readiness, end of file only means no new data */
+    bool closed[BUTTON_INPUT_MAX];      /**< Hung up or failed; keeps its last level */
+    int fd_flags[BUTTON_INPUT_MAX];     /**< epoll: file status flags before O_NONBLOCK was set; -1 if unchanged */
+    button_input_decode_fn decode;
+    uint8_t bufs[BUTTON_INPUT_MAX][BUTTON_INPUT_BUF_SIZE];
+
+    /* io_uring rings (mapped) */
+    int ring_fd;
+    void *sq_ring;
+    size_t sq_ring_size;
+    void *cq_ring;
+    size_t cq_ring_size;
+    void *sqes;
+    size_t sqes_size;
+    unsigned int *sq_head, *sq_tail, *sq_mask, *sq_array;
+    unsigned int *cq_head, *cq_tail, *cq_mask;
+    void *cqes;
+
+    /* epoll fallback */
+    int epoll_fd;
+} button_input_t;
+
+// API
+button_error_t ButtonInput_Open(button_input_t* input, const int* fds, uint16_t count, bool use_io_uring);
+button_error_t ButtonInput_SetDecoder(button_input_t* input, button_input_decode_fn decode);
+button_error_t ButtonInput_Poll(button_input_t* input, uint16_t* changed);
+bool ButtonInput_Level(const button_input_t* input, uint32_t index);
+button_error_t ButtonInput_Close(button_input_t* input);
+
+#endif // BUTTON_INPUT_H
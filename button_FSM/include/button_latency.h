@@ -0,0 +1,67 @@
+/**
+ * @file    button_latency.h
+ * @author  datngyB
+ * @brief   Edge-to-event latency histograms, one per button.
+ * @version 0.1.0
+ * @date    2026-10-18
+ * * @copyright Copyright (c) 2026
+ *
+ * The latency of a PRESSED or RELEASED event is the time from the physical
+ * edge to the dispatch of its handlers, in ticks. It covers debounce, scan
+ * period and the sweep position of the button. The edge time comes from an
+ * edge interrupt when the application reports one (Button_BankMarkEdge);
+ * otherwise the first sample that saw the new level stands in for it, which
+ * hides up to one scan period.
+ *
+ * Latencies are counted in power-of-two buckets: bucket 0 holds 0 ticks,
+ * bucket b holds [2^(b-1), 2^b) ticks, and the last bucket everything above.
+ * Percentiles are reported as the upper bound of their bucket, which is what
+ * an SLO check ("p99 below 40 ms") needs.
+ *
+ * The sweeping thread records while other threads report, so a histogram is
+ * read through ButtonLatency_Snapshot: a sequence counter, odd while Record
+ * or Reset writes, makes the copy retry until count, sum, max and buckets
+ * come from the same moment. Percentiles are taken from the snapshot. Reset
+ * belongs to the sweeping thread, or to setup before the first sweep.
+ */
+
+#ifndef BUTTON_LATENCY_H
+#define BUTTON_LATENCY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "button_static.h"
+
+#ifndef BUTTON_LATENCY_BUCKETS
+#define BUTTON_LATENCY_BUCKETS      16  /* Up to 2^14 ticks resolved; the last bucket is open-ended */
+#endif
+#define BUTTON_LATENCY_READ_RETRIES 1000u   /* Snapshot attempts before giving up on a writer that does not finish */
+
+/* Latency statistics and pending edge of one button (RAM) */
+typedef struct {
+    atomic_uint_least32_t edge_tick;    /**< Edge of the transition in progress */
+    atomic_bool edge_valid;             /**< edge_tick is set and not yet consumed by an event */
+    atomic_uint_least32_t seq;          /**< Odd while the histogram below is written */
+    atomic_uint_least32_t count;        /**< Events measured */
+    atomic_uint_least32_t max_ticks;
+    atomic_uint_least32_t sum_lo;       /**< Sum of the latencies in two words: no 64-bit atomics on small cores */
+    atomic_uint_least32_t sum_hi;
+    atomic_uint_least32_t buckets[BUTTON_LATENCY_BUCKETS];
+} button_latency_t;
+
+/* Consistent copy of one histogram */
+typedef struct {
+    uint32_t count;
+    uint32_t max_ticks;
+    uint64_t sum_ticks;
+    uint32_t buckets[BUTTON_LATENCY_BUCKETS];
+} button_latency_snapshot_t;
+
+// API
+void ButtonLatency_Reset(button_latency_t* latency);
+void ButtonLatency_Record(button_latency_t* latency, uint32_t ticks);
+button_error_t ButtonLatency_Snapshot(const button_latency_t* latency, button_latency_snapshot_t* snapshot);
+button_error_t ButtonLatency_Percentile(const button_latency_snapshot_t* snapshot, uint8_t percent, uint32_t* ticks);
+
+#endif // BUTTON_LATENCY_H
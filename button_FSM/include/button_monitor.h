@@ -0,0 +1,85 @@
+/**
+ * @file    button_monitor.h
+ * @author  datngyB
+ * @brief   Live state page of a bank for external monitoring tools.
+ * @version 0.1.0
+ * @date    2026-10-18
+ * * @copyright Copyright (c) 2026
+ *
+ * The sweeping thread keeps one slot per button up to date in place: FSM
+ * state, last event, start of the current press and tick of the last event
+ * (Button_BankConfigMonitor). Readers copy slots without syscalls and
+ * without blocking the sweep; a page-wide sequence counter, odd while a sweep
+ * is writing, tells them to retry. Sweeps that change nothing leave the
+ * counter alone and only refresh the page tick.
+ *
+ * On Linux the page lives in POSIX shared memory (ButtonMonitor_Create) and
+ * diagnostic tools map it read-only (ButtonMonitor_Attach). The layout is
+ * fixed-width little endian words, so tools in other languages can read it:
+ *   0  u32 magic "BMON"      8  u32 sequence
+ *   4  u16 version           12 u32 tick of the last sweep
+ *   6  u16 button count      16 slots, 12 bytes each:
+ *        u32 status (state | last event << 8), u32 press start, u32 last event tick
+ *
+ * The publisher removes the name with ButtonMonitor_Unlink when it shuts
+ * down; mapped readers keep the page until they close it.
+ */
+
+#ifndef BUTTON_MONITOR_H
+#define BUTTON_MONITOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include "button_static.h"
+
+#define BUTTON_MONITOR_MAGIC        0x4E4F4D42u     /* "BMON" */
+#define BUTTON_MONITOR_VERSION      1u
+#define BUTTON_MONITOR_READ_RETRIES 1000u           /* Attempts before a reader gives up on a stalled writer */
+
+#define BUTTON_MONITOR_STATUS(state, event)     ((uint32_t)(state) | ((uint32_t)(event) << 8))
+#define BUTTON_MONITOR_STATE(status)            ((button_state_t)((status) & 0xFFu))
+#define BUTTON_MONITOR_EVENT(status)            ((button_event_t)(((status) >> 8) & 0xFFu))
+
+/* One button of the page */
+typedef struct {
+    atomic_uint_least32_t status;           /**< BUTTON_MONITOR_STATUS(state, last event) */
+    atomic_uint_least32_t press_start_tick; /**< Start of the current or last press */
+    atomic_uint_least32_t last_event_tick;  /**< Sweep tick of the last event; 0 before the first one */
+} button_monitor_slot_t;
+
+typedef struct {
+    uint32_t magic;                 /**< BUTTON_MONITOR_MAGIC once the page is complete */
+    uint16_t version;
+    uint16_t count;                 /**< Slots that follow */
+    atomic_uint_least32_t seq;      /**< Odd while the sweeping thread writes slots */
+    atomic_uint_least32_t tick;     /**< Tick of the last sweep */
+    button_monitor_slot_t slots[];
+} button_monitor_page_t;
+
+#define BUTTON_MONITOR_PAGE_SIZE(count) (sizeof(button_monitor_page_t) + (size_t)(count) * sizeof(button_monitor_slot_t))
+
+/* Consistent copy of one slot */
+typedef struct {
+    button_state_t state;
+    button_event_t last_event;
+    uint32_t press_start_tick;
+    uint32_t last_event_tick;
+} button_monitor_sample_t;
+
+/* Shared-memory mapping of a page (Linux hosts) */
+typedef struct {
+    button_monitor_page_t *page;
+    size_t size;
+} button_monitor_map_t;
+
+// API (Linux hosts)
+button_error_t ButtonMonitor_Create(button_monitor_map_t* map, const char* name, uint16_t count, bool take_over);
+button_error_t ButtonMonitor_Attach(button_monitor_map_t* map, const char* name);
+button_error_t ButtonMonitor_Read(const button_monitor_page_t* page, uint16_t first, uint16_t n,
+                                  button_monitor_sample_t* samples, uint32_t* tick);
+button_error_t ButtonMonitor_Close(button_monitor_map_t* map);
+button_error_t ButtonMonitor_Unlink(const char* name);
+
+#endif // BUTTON_MONITOR_H
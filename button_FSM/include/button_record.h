@@ -0,0 +1,76 @@
+/**
+ * @file    button_record.h
+ * @author  datngyB
+ * @brief   Packed 4-byte event records in batches, for queues and journals.
+ * @version 0.1.0
+ * @date    2026-10-18
+ * * @copyright Copyright (c) 2026
+ *
+ * An event is one 32-bit word: bank index, event code and the tick offset
+ * from the base tick of its batch. A batch starts with a two-word header
+ * holding the absolute base tick and the record count. A new batch is opened
+ * only when the offset no longer fits (about 65 s at 1 kHz), so quiet periods
+ * cost one header instead of a wider record. Indexes above
+ * BUTTON_RECORD_MAX_INDEX (4095) are rejected.
+ *
+ * Record word:  bits 0..11 index, bits 12..15 event, bits 16..31 tick offset
+ * Batch header: word 0 base tick, word 1 record count
+ *
+ * Usage:
+ *     ButtonRecord_LogInit(&log, words, 256, systick_get);
+ *     Button_BankRegisterHandler(&bank, ButtonRecord_OnEvent, &log);
+ *     ...
+ *     ButtonRecord_ReaderInit(&rd, log.words, log.used);
+ *     while (ButtonRecord_Read(&rd, &index, &event, &tick)) { ... }
+ */
+
+#ifndef BUTTON_RECORD_H
+#define BUTTON_RECORD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "button_static.h"
+
+typedef uint32_t button_record_t;
+
+#define BUTTON_RECORD_MAX_INDEX     0x0FFFu
+#define BUTTON_RECORD_MAX_DELTA     0xFFFFu
+#define BUTTON_RECORD_HEADER_WORDS  2u
+
+#define BUTTON_RECORD_PACK(index, event, delta) \
+    ((button_record_t)(((uint32_t)(index) & 0x0FFFu) | (((uint32_t)(event) & 0x0Fu) << 12) | ((uint32_t)(delta) << 16)))
+#define BUTTON_RECORD_INDEX(rec)    ((uint16_t)((rec) & 0x0FFFu))
+#define BUTTON_RECORD_EVENT(rec)    ((button_event_t)(((rec) >> 12) & 0x0Fu))
+#define BUTTON_RECORD_DELTA(rec)    ((uint16_t)((rec) >> 16))
+
+_Static_assert(BUTTON_EVENT_MAX <= 16, "event codes must fit the 4-bit record field");
+
+/* Writer over caller RAM; one producer (the sweeping thread) */
+typedef struct {
+    uint32_t *words;
+    uint32_t capacity;          /**< In words */
+    uint32_t used;              /**< Words written, headers included */
+    uint32_t batch;             /**< Word offset of the open batch header */
+    bool open;                  /**< A batch is open and takes more records */
+    get_tick_fn get_tick_func;  /**< Tick source of ButtonRecord_OnEvent */
+    uint32_t dropped;           /**< Events lost because the buffer was full */
+} button_record_log_t;
+
+typedef struct {
+    const uint32_t *words;
+    uint32_t used;
+    uint32_t pos;
+    uint32_t left;              /**< Records left in the current batch */
+    uint32_t base_tick;
+} button_record_reader_t;
+
+// API
+button_error_t ButtonRecord_LogInit(button_record_log_t* log, uint32_t* words, uint32_t capacity, get_tick_fn tick_fn);
+button_error_t ButtonRecord_Append(button_record_log_t* log, uint16_t index, button_event_t event, uint32_t tick);
+void ButtonRecord_OnEvent(uint16_t index, button_event_t event, void* context);
+button_error_t ButtonRecord_LogReset(button_record_log_t* log);
+
+button_error_t ButtonRecord_ReaderInit(button_record_reader_t* reader, const uint32_t* words, uint32_t used);
+bool ButtonRecord_Read(button_record_reader_t* reader, uint16_t* index, button_event_t* event, uint32_t* tick);
+
+#endif // BUTTON_RECORD_H
@@ -0,0 +1,127 @@
+/**
+ * @file    button_registry.h
+ * @author  datngyB
+ * @brief   Link-time button registry: buttons declared as const descriptors, no registration code.
+ * @version 0.1.0
+ * @date    2026-10-18
+ * * @copyright Copyright (c) 2026
+ *
+ * BUTTON_DEFINE places a const button_bank_entry_t in the "button_registry"
+ * section and one button_bank_state_t in the "button_state" section, which is
+ * emitted as NOBITS (.bss-like: no bytes in the image). The linker gathers
+ * both into contiguous arrays, which form a bank that Button_RegistryUpdate
+ * sweeps. No registration code runs at startup: the first
+ * Button_RegistryUpdate or Button_RegistryBank call builds the bank and
+ * writes every state through Button_BankInit, so the states do not rely on
+ * the startup code clearing them.
+ *
+ * Descriptors and states are matched by position; states are anonymous so the
+ * order the linker picks does not matter, only that both sections hold the
+ * same number of elements.
+ *
+ * The entry callbacks of BUTTON_DEFINE are const and never change. A handler
+ * registered on Button_RegistryBank() is retired like any bank handler: wait
+ * for Button_BankHandlerGrace before freeing its context.
+ *
+ * GNU ld / lld provide __start_<section> and __stop_<section> for orphan
+ * sections. With a custom linker script, keep both sections (KEEP), e.g. inside
+ * the .bss output section:
+ *     __start_button_state = .; KEEP(*(button_state)) __stop_button_state = .;
+ * or override the bound macros below.
+ *
+ * Example:
+ *     BUTTON_REGISTRY_PROFILES(my_profiles);
+ *     BUTTON_REGISTRY_HAL(gpio_read, systick_get);
+ *     BUTTON_DEFINE(btn_ok,   5, BUTTON_ACTIVE_LOW, 0, on_ok,   NULL);
+ *     BUTTON_DEFINE(btn_back, 6, BUTTON_ACTIVE_LOW, 1, on_back, NULL);
+ *     ...
+ *     for (;;) { Button_RegistryUpdate(); sleep_until_next_scan(); }
+ */
+
+#ifndef BUTTON_REGISTRY_H
+#define BUTTON_REGISTRY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "button_bank.h"
+
+#if !defined(__GNUC__)
+#error "button_registry.h needs section attributes (GCC/Clang compatible compiler)"
+#endif
+
+#ifndef BUTTON_REGISTRY_ENTRY_START
+#define BUTTON_REGISTRY_ENTRY_START     __start_button_registry
+#define BUTTON_REGISTRY_ENTRY_STOP      __stop_button_registry
+#endif
+#ifndef BUTTON_REGISTRY_STATE_START
+#define BUTTON_REGISTRY_STATE_START     __start_button_state
+#define BUTTON_REGISTRY_STATE_STOP      __stop_button_state
+#endif
+
+/*
+ * Clang already emits zero-initialized data in a named section as NOBITS. GCC
+ * only does so for .bss.* names, which would lose the __start_/__stop_ bounds,
+ * so the section type is appended to the name; the assembler comment character
+ * hides the flags GCC adds after it.
+ */
+#ifndef BUTTON_REGISTRY_STATE_SECTION
+#if defined(__clang__)
+#define BUTTON_REGISTRY_STATE_SECTION   "button_state"
+#elif defined(__aarch64__)
+#define BUTTON_REGISTRY_STATE_SECTION   "button_state,\"aw\",%nobits//"
+#elif defined(__arm__)
+#define BUTTON_REGISTRY_STATE_SECTION   "button_state,\"aw\",%nobits@"
+#else
+#define BUTTON_REGISTRY_STATE_SECTION   "button_state,\"aw\",%nobits#"
+#endif
+#endif
+
+/* Weak: an image without any BUTTON_DEFINE still links, with an empty registry */
+extern const button_bank_entry_t BUTTON_REGISTRY_ENTRY_START[] __attribute__((weak));
+extern const button_bank_entry_t BUTTON_REGISTRY_ENTRY_STOP[] __attribute__((weak));
+extern button_bank_state_t BUTTON_REGISTRY_STATE_START[] __attribute__((weak));
+extern button_bank_state_t BUTTON_REGISTRY_STATE_STOP[] __attribute__((weak));
+
+/* Defined by BUTTON_REGISTRY_PROFILES / BUTTON_REGISTRY_HAL; the profile table is optional */
+extern const button_profile_t *const button_registry_profiles;
+extern const uint8_t button_registry_profile_count;
+extern const button_read_gpio_fn button_registry_read_fn;
+extern const get_tick_fn button_registry_tick_fn;
+
+/* Entry handler fields; without BUTTON_FEATURE_DISPATCH the handler arguments are ignored */
+#if BUTTON_FEATURE_DISPATCH
+#define BUTTON_REGISTRY_HANDLER(cb, ctx)    .callback = (cb), .context = (ctx)
+#else
+#define BUTTON_REGISTRY_HANDLER(cb, ctx)
+#endif
+
+/* Declares button @p name; @p profile_id indexes the registry profile table */
+#define BUTTON_DEFINE(name, gpio, level, profile_id, cb, ctx)                                   \
+    const button_bank_entry_t name                                                              \
+        __attribute__((used, section("button_registry"), aligned(__alignof__(button_bank_entry_t)))) = { \
+        .gpio_num = (gpio), .active_level = (level), .profile = (profile_id),                   \
+        BUTTON_REGISTRY_HANDLER(cb, ctx) };                                                     \
+    static button_bank_state_t name##_state                                                     \
+        __attribute__((used, section(BUTTON_REGISTRY_STATE_SECTION), aligned(__alignof__(button_bank_state_t))))
+
+/* Makes a button defined in another translation unit visible (for BUTTON_REGISTRY_INDEX) */
+#define BUTTON_DECLARE(name)            extern const button_bank_entry_t name
+
+/* Bank index of a registered button, as passed to bank handlers */
+#define BUTTON_REGISTRY_INDEX(name)     ((uint16_t)(&(name) - BUTTON_REGISTRY_ENTRY_START))
+
+/* Profile table of the registry; without it, one profile with compile-time timings and no stages */
+#define BUTTON_REGISTRY_PROFILES(table)                                                         \
+    const button_profile_t *const button_registry_profiles = (table);                          \
+    const uint8_t button_registry_profile_count = (uint8_t)(sizeof(table) / sizeof((table)[0]))
+
+/* HAL hooks shared by every registered button */
+#define BUTTON_REGISTRY_HAL(read_fn, tick_fn)                                                   \
+    const button_read_gpio_fn button_registry_read_fn = (read_fn);                             \
+    const get_tick_fn button_registry_tick_fn = (tick_fn)
+
+// API
+button_error_t Button_RegistryUpdate(void);
+button_bank_t* Button_RegistryBank(void);
+
+#endif // BUTTON_REGISTRY_H
@@ -0,0 +1,86 @@
+/**
+ * @file    button_replica.h
+ * @author  datngyB
+ * @brief   Delta replication of bank state to a standby controller.
+ * @version 0.1.0
+ * @date    2026-10-18
+ * * @copyright Copyright (c) 2026
+ *
+ * The encoder drains the bank dirty mask (Button_BankConfigDirty) after a
+ * sweep and writes only the buttons whose FSM state changed into a frame. The
+ * standby applies frames to its own bank, initialized with the same entries
+ * and profiles, so it can take over mid-press: a long press that started on
+ * the primary ends with the right events on the standby.
+ *
+ * Timestamps travel as ages relative to the sender's clock at encode time and
+ * are rebased on the standby clock, so the two controllers need no shared
+ * time base. Only the fields the FSM reads in the button's state are sent.
+ *
+ * Frame layout (little endian, varints are LEB128):
+ *   0  u8[2] magic "BR"       4  u32 sequence        8  u16 payload bytes
+ *   2  u8    version                                 10 u16 record count
+ *   3  u8    flags
+ *   then per record: varint index gap (index - previous index - 1),
+ *   u8 state, u8 profile, varint age of the last change; in
+ *   STATE_LONG_PRESSED also varint ages of the press start and last HOLD,
+ *   varint stage latches and u8 HOLD stage.
+ *
+ * The frame length is known from the header, so frames can be carried over
+ * a byte stream (pipe, TCP) as well as a datagram socket. A frame flagged
+ * BUTTON_REPLICA_FLAG_SYNC starts a full snapshot; the standby is in sync
+ * once a snapshot completes and every later frame arrives in sequence.
+ *
+ * Usage (primary, sweeping thread):
+ *     Button_BankConfigDirty(&bank, dirty);
+ *     ButtonReplica_EncoderInit(&enc);
+ *     for (;;) { Button_BankUpdate(&bank);
+ *                do { ButtonReplica_Encode(&enc, &bank, buf, sizeof(buf), &len);
+ *                     if (len) write(fd, buf, len); } while (enc.pending); }
+ * Usage (standby):
+ *     read(fd, hdr, BUTTON_REPLICA_HEADER_SIZE); ButtonReplica_FrameLength(hdr, &len);
+ *     read the rest; ButtonReplica_Apply(&dec, &standby, frame, len);
+ */
+
+#ifndef BUTTON_REPLICA_H
+#define BUTTON_REPLICA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "button_bank.h"
+
+#define BUTTON_REPLICA_HEADER_SIZE  12u
+#define BUTTON_REPLICA_MAX_RECORD   26u     /* 3 (gap) + 2 + 4 * 5 (ages, latches) + 1 */
+#define BUTTON_REPLICA_MIN_FRAME    (BUTTON_REPLICA_HEADER_SIZE + BUTTON_REPLICA_MAX_RECORD)
+#define BUTTON_REPLICA_VERSION      2u
+
+#define BUTTON_REPLICA_FLAG_SYNC    0x01u   /* First frame of a full snapshot */
+#define BUTTON_REPLICA_FLAG_MORE    0x02u   /* Changes did not fit: the next frame continues this sweep */
+
+/* Encoder side: owned by the thread that sweeps the primary bank */
+typedef struct {
+    uint32_t sequence;          /**< Sequence number of the next frame */
+    bool resync;                /**< Next frame starts a full snapshot */
+    bool pending;               /**< Dirty buttons left over by the last frame */
+} button_replica_encoder_t;
+
+/* Decoder side: owned by the thread that applies frames to the standby bank */
+typedef struct {
+    uint32_t next_sequence;
+    bool has_sequence;          /**< A frame was applied: next_sequence is meaningful */
+    bool chained;               /**< Frames since the last snapshot arrived in sequence */
+    bool synced;                /**< A snapshot completed and the chain is unbroken: safe to take over */
+    uint32_t lost_frames;       /**< Frames skipped by forward sequence gaps so far */
+    uint32_t stale_frames;      /**< Reordered or duplicated delta frames dropped */
+} button_replica_decoder_t;
+
+// API
+button_error_t ButtonReplica_EncoderInit(button_replica_encoder_t* enc);
+button_error_t ButtonReplica_Resync(button_replica_encoder_t* enc);
+button_error_t ButtonReplica_Encode(button_replica_encoder_t* enc, button_bank_t* bank, uint8_t* buf, size_t cap, size_t* len);
+
+button_error_t ButtonReplica_DecoderInit(button_replica_decoder_t* dec);
+button_error_t ButtonReplica_FrameLength(const uint8_t* header, size_t* len);
+button_error_t ButtonReplica_Apply(button_replica_decoder_t* dec, button_bank_t* bank, const uint8_t* frame, size_t len);
+
+#endif // BUTTON_REPLICA_H
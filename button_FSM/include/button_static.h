@@ -12,11 +12,49 @@
 
 #include <stdint.h>
 #include <stdbool.h>
-
+#include <stdatomic.h>
+
+/* Rounded up: a threshold is never shorter than the time asked for */
+#define BUTTON_MS_TO_TICKS(ms, tick_hz) ((uint32_t)(((uint64_t)(ms) * (uint64_t)(tick_hz) + 999u) / 1000u))
+
+#ifdef BUTTON_TICK_HZ
+/* Timings in milliseconds, converted to ticks at compile time for the given tick rate */
+#ifndef BUTTON_DEBOUNCE_MS
+#define BUTTON_DEBOUNCE_MS          50
+#endif
+#ifndef BUTTON_LONG_PRESS_MS
+#define BUTTON_LONG_PRESS_MS        1000
+#endif
+#ifndef BUTTON_HOLD_MS
+#define BUTTON_HOLD_MS              50
+#endif
+#ifndef BUTTON_SUPER_LONG_PRESS_MS
+#define BUTTON_SUPER_LONG_PRESS_MS  5000
+#endif
+#define BUTTON_DEBOUNCE_TICKS       BUTTON_MS_TO_TICKS(BUTTON_DEBOUNCE_MS, BUTTON_TICK_HZ)
+#define BUTTON_LONG_PRESS_TICKS     BUTTON_MS_TO_TICKS(BUTTON_LONG_PRESS_MS, BUTTON_TICK_HZ)
+#define BUTTON_HOLD_TICKS           BUTTON_MS_TO_TICKS(BUTTON_HOLD_MS, BUTTON_TICK_HZ)
+#define BUTTON_SUPER_LONG_PRESS_TICKS   BUTTON_MS_TO_TICKS(BUTTON_SUPER_LONG_PRESS_MS, BUTTON_TICK_HZ)
+#else
 #define BUTTON_DEBOUNCE_TICKS       50   
 #define BUTTON_LONG_PRESS_TICKS     1000 
 #define BUTTON_HOLD_TICKS           50 
 #define BUTTON_SUPER_LONG_PRESS_TICKS   5000
+#endif
+
+/* Feature selection: build with e.g. -DBUTTON_FEATURE_HOLD=0 to compile a feature out */
+#ifndef BUTTON_FEATURE_STAGES
+#define BUTTON_FEATURE_STAGES       1   /* Multi-stage tables (Button_ConfigStages, bank profile stages) */
+#endif
+#ifndef BUTTON_FEATURE_HOLD
+#define BUTTON_FEATURE_HOLD         1   /* HOLD repeat while long pressed */
+#endif
+#ifndef BUTTON_FEATURE_SUPER_LONG
+#define BUTTON_FEATURE_SUPER_LONG   0   /* Built-in SUPER_LONG_PRESSED at BUTTON_SUPER_LONG_PRESS_TICKS, without a stage table */
+#endif
+#ifndef BUTTON_FEATURE_DISPATCH
+#define BUTTON_FEATURE_DISPATCH     1   /* button_t callbacks; when 0, events are only kept in last_event for polling */
+#endif
 
 /* Defines the electrical */
 typedef enum {
@@ -34,15 +72,21 @@ typedef enum {
     BUTTON_EVENT_LONG_PRESSED,     /* BUTTON IS PRESSED MORE THAN LONG_PRESS_TICKS */
     BUTTON_EVENT_HOLD,           /* BUTTON IS PRESSED MORE THAN LONG_PRESS_TICKS + HOLD_TICKS */
     BUTTON_EVENT_SUPER_LONG_PRESSED, /* BUTTON IS PRESSED MORE THAN SUPER_LONG_PRESS_TICKS */
+    BUTTON_EVENT_POWER_ON_HELD,    /* BUTTON WAS ALREADY HELD AT INIT (replaces PRESSED for that press) */
     BUTTON_EVENT_MAX               /* parameter validation. */
 } button_event_t;
 
+/* Set of events: bit e is event e (BUTTON_EVENT_BIT) */
+typedef uint16_t button_event_mask_t;
+#define BUTTON_EVENT_BIT(event)     ((button_event_mask_t)(1u << (event)))
+
 /* Physical state of the input general button*/
 typedef enum {
     STATE_IDLE,
     STATE_DEBOUNCE,
     STATE_PRESSED,
-    STATE_LONG_PRESSED
+    STATE_LONG_PRESSED,
+    STATE_POWER_ON_HELD     /* Held at init: dispatches POWER_ON_HELD on the first update, then acts as PRESSED */
 } button_state_t;
 
 
@@ -50,9 +94,13 @@ typedef enum {
  * This structure is typically stored in Flash to save RAM */
 typedef struct {
     uint32_t threshold;     // Time in ticks to trigger
-    button_event_t event;   // Event to dispatch
+    button_event_t event;   // Event to dispatch, BUTTON_EVENT_NONE < event < BUTTON_EVENT_MAX
+    uint32_t hold_ticks;    // HOLD repeat interval from this stage on; 0 keeps the current one, BUTTON_HOLD_OFF stops HOLD
 } button_stage_config_t;
 
+#define BUTTON_HOLD_OFF             0xFFFFFFFFu
+#define BUTTON_STAGE_NONE           0xFFu   /* Stage index of events that do not come from a stage table */
+
 /* 2. Multi-stage manager inside button_t */
 // this place keeping array and variable runtime (RAM)
 typedef struct {
@@ -66,12 +114,36 @@ typedef struct {
 typedef void (*button_callback_fn)(button_event_t event, void* context);
 typedef bool (*button_read_gpio_fn)(uint32_t pin_mask);
 typedef uint32_t (*get_tick_fn)(void);
+#if BUTTON_FEATURE_STAGES
+/* Stage events with the index of the stage that fired and its threshold in ticks */
+typedef void (*button_stage_callback_fn)(button_event_t event, uint8_t stage, uint32_t threshold, void* context);
+#endif
+
+#if BUTTON_FEATURE_DISPATCH
+/* One handler set; each field is read atomically by the dispatcher */
+typedef struct {
+    _Atomic(button_callback_fn) callback;
+    _Atomic(void*) context;
+#if BUTTON_FEATURE_STAGES
+    _Atomic(button_stage_callback_fn) stage_callback;   /**< Optional; takes stage events instead of @c callback */
+#endif
+} button_handler_t;
+#endif
+
+/* Optional behaviour of Button_InitEx */
+typedef struct {
+    bool detect_held;               /**< Sample the pin at init; if pressed, start in the pressed state */
+    uint32_t held_backdate_ticks;   /**< Assumed hold time before init, counted towards long press */
+} button_init_config_t;
 
 typedef struct {
     /* Timing tracking */
     uint32_t last_change_tick;      /**< Timestamp of the last state transition or hold pulse */
     uint32_t press_start_tick;      /**< Absolute timestamp when the button was first validated as pressed */
     uint32_t last_hold_tick;       /**< Timestamp of the last dispatched HOLD event for repeat logic */
+#if BUTTON_FEATURE_STAGES && BUTTON_FEATURE_HOLD
+    uint32_t hold_interval;        /**< HOLD repeat interval in effect; BUTTON_HOLD_TICKS until a stage changes it */
+#endif
 
     /* Hardware configuration */
     uint32_t gpio_num;                   /**< Physical GPIO identifier assigned to this button instance */
@@ -80,16 +152,20 @@ typedef struct {
     /* State Machine internal variables */
     button_state_t last_state;      /**< Current internal state of the Finite State Machine (FSM) */
     button_event_t last_event;      /**< The most recently dispatched event to the application layer */
-    bool is_long_pressed_triggered; /**< One-time latch flag to prevent multiple Long Press triggers per cycle */
+    bool is_long_pressed_triggered; /**< One-time latch flag to prevent multiple Long Press triggers per cycle; stays false without BUTTON_FEATURE_SUPER_LONG */
     
     /* Application Abstraction Layer */
-    void* context;                  /**< Pointer to user-defined data passed back via callback (for reentrancy) */
-    button_callback_fn callback;    /**< Application-level function pointer for asynchronous event notification */
+#if BUTTON_FEATURE_DISPATCH
+    button_handler_t handlers[2];   /**< Double-buffered callback/context pair; the live one is selected by handler_seq */
+    atomic_uint handler_seq;        /**< Bumped by every (un)registration; bit 0 selects the live handler */
+#endif
     button_read_gpio_fn read_pin_func; /**< Function pointer to the Low-Level Driver (LLD) GPIO read routine */
     get_tick_fn get_tick_func;        /**< Function pointer to the system tick retrieval routine */
 
+#if BUTTON_FEATURE_STAGES
     /* Multi-stage Long Press Support */
     button_stage_manager_t stages; /**< Multi-stage long press manager */
+#endif
 } button_t;
 
 typedef enum {
@@ -103,10 +179,20 @@ typedef enum {
 
 // API 
 button_error_t Button_Init(button_t* button, uint32_t gpio_num, button_active_level_t level, button_read_gpio_fn read_fn, get_tick_fn tick_fn);
+button_error_t Button_InitEx(button_t* button, uint32_t gpio_num, button_active_level_t level, button_read_gpio_fn read_fn, get_tick_fn tick_fn,
+                             const button_init_config_t* config);
+#if BUTTON_FEATURE_STAGES
 button_error_t Button_ConfigStages(button_t* button, const button_stage_config_t* configs, bool* latches, uint8_t count);
+#endif
 button_error_t Button_Update(button_t* button);   
+button_error_t Button_UpdateEx(button_t* button, button_event_mask_t* events);
+#if BUTTON_FEATURE_DISPATCH
 button_error_t Button_RegisterHandler(button_t* button, button_callback_fn callback, void* context);
+#if BUTTON_FEATURE_STAGES
+button_error_t Button_RegisterHandlerEx(button_t* button, button_callback_fn callback, button_stage_callback_fn stage_callback, void* context);
+#endif
 button_error_t Button_UnregisterHandler(button_t* button);
+#endif
 button_error_t Button_Deinit(button_t* button);
 
 #endif // BUTTON_STATIC_H
\ No newline at end of file
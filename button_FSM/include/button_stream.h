@@ -0,0 +1,83 @@
+/**
+ * @file    button_stream.h
+ * @author  datngyB
+ * @brief   Batched button event stream over a Unix domain socket (Linux hosts).
+ * @version 0.1.0
+ * @date    2026-10-18
+ * * @copyright Copyright (c) 2026
+ *
+ * The publisher collects the events of one bank sweep and sends them as one
+ * SOCK_SEQPACKET message per connected client, so a burst costs one syscall
+ * per client instead of one per event. Message boundaries are kept by the
+ * socket, so a frame is always received whole.
+ *
+ * Frame layout (little endian):
+ *   0  u8[2] magic "BS"       4  u32 sequence        12 u16 event count
+ *   2  u8    version          8  u32 sweep tick      14 u16 reserved
+ *   3  u8    flags
+ *   then per event: u16 bank index, u8 event, u8 reserved
+ *
+ * Usage:
+ *     ButtonStream_Open(&pub, "/run/buttons.sock");
+ *     Button_BankRegisterHandler(&bank, ButtonStream_OnEvent, &pub);
+ *     for (;;) { Button_BankUpdate(&bank); ButtonStream_Flush(&pub, tick()); ... }
+ */
+
+#ifndef BUTTON_STREAM_H
+#define BUTTON_STREAM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "button_static.h"
+
+#define BUTTON_STREAM_MAX_CLIENTS   8
+#ifndef BUTTON_STREAM_MAX_EVENTS
+#define BUTTON_STREAM_MAX_EVENTS    256     /* Per sweep; size it to the largest expected burst */
+#endif
+#define BUTTON_STREAM_HEADER_SIZE   16u
+#define BUTTON_STREAM_RECORD_SIZE   4u
+#define BUTTON_STREAM_MAX_FRAME     (BUTTON_STREAM_HEADER_SIZE + BUTTON_STREAM_MAX_EVENTS * BUTTON_STREAM_RECORD_SIZE)
+#define BUTTON_STREAM_VERSION       1u
+#define BUTTON_STREAM_PATH_MAX      108u    /* sun_path of struct sockaddr_un, terminator included */
+
+#define BUTTON_STREAM_FLAG_TRUNCATED 0x01u  /* Events of this sweep were dropped: more than BUTTON_STREAM_MAX_EVENTS */
+
+/* One decoded event */
+typedef struct {
+    uint16_t index;             /**< Bank index of the button */
+    button_event_t event;
+} button_stream_event_t;
+
+/* Publisher side: owned by the thread that sweeps the bank */
+typedef struct {
+    int listen_fd;
+    char path[BUTTON_STREAM_PATH_MAX]; /**< Bound socket path, removed by Close */
+    int clients[BUTTON_STREAM_MAX_CLIENTS];
+    uint8_t client_count;
+    uint32_t sequence;          /**< Frame counter; gaps tell a client it missed frames */
+    uint16_t event_count;       /**< Events batched since the last flush */
+    bool truncated;
+    uint32_t dropped_frames;    /**< Frames not delivered because a client queue was full */
+    uint8_t frame[BUTTON_STREAM_MAX_FRAME];
+} button_stream_pub_t;
+
+/* Client side */
+typedef struct {
+    int fd;
+    uint32_t last_sequence;
+    uint32_t lost_frames;       /**< Sequence gaps seen so far */
+    bool has_sequence;
+} button_stream_client_t;
+
+// API
+button_error_t ButtonStream_Open(button_stream_pub_t* pub, const char* path);
+void ButtonStream_OnEvent(uint16_t index, button_event_t event, void* context);
+button_error_t ButtonStream_Flush(button_stream_pub_t* pub, uint32_t tick);
+button_error_t ButtonStream_Close(button_stream_pub_t* pub);
+
+button_error_t ButtonStream_Connect(button_stream_client_t* client, const char* path);
+button_error_t ButtonStream_Receive(button_stream_client_t* client, button_stream_event_t* events, uint16_t max_events,
+                                    uint16_t* count, uint32_t* tick, uint8_t* flags);
+button_error_t ButtonStream_Disconnect(button_stream_client_t* client);
+
+#endif // BUTTON_STREAM_H
@@ -0,0 +1,379 @@
+#define     _GNU_SOURCE
+#include    <stdbool.h>
+#include    <stdint.h>
+#include    <stddef.h>
+#include    <string.h>
+#include    <errno.h>
+#include    <fcntl.h>
+#include    <unistd.h>
+#include    <sys/mman.h>
+#include    <sys/stat.h>
+#include    <sys/epoll.h>
+#include    <sys/syscall.h>
+#include    <linux/io_uring.h>
+#include    "button_input.h"
+
+#define BUTTON_INPUT_CANCEL_TAG     ((uint64_t)1 << 32)    /* user_data of cancel requests, above any input index */
+
+static bool uring_setup(button_input_t* input);
+static void uring_teardown(button_input_t* input);
+static void uring_cancel(button_input_t* input);
+static uint16_t uring_poll(button_input_t* input);
+static uint16_t uring_reap(button_input_t* input);
+static bool epoll_setup(button_input_t* input);
+static void epoll_teardown(button_input_t* input);
+static uint16_t epoll_poll(button_input_t* input);
+static bool read_input(button_input_t* input, uint16_t i);
+static bool apply_data(button_input_t* input, uint16_t i, size_t len);
+static bool decode_level(const uint8_t* data, size_t len, bool level);
+
+
+/*
+ * @p fds are owned by the caller and must stay open until ButtonInput_Close.
+ * With @p use_io_uring false, or when the kernel refuses a ring, epoll is used.
+ */
+button_error_t ButtonInput_Open(button_input_t* input, const int* fds, uint16_t count, bool use_io_uring) {
+    if (!input || !fds || count == 0 || count > BUTTON_INPUT_MAX) return BUTTON_ERR_INVALID_ARG;
+
+    memset(input, 0, sizeof(*input));
+    input->ring_fd = -1;
+    input->epoll_fd = -1;
+    input->decode = decode_level;
+    input->count = count;
+
+    for (uint16_t i = 0; i < count; i++) {
+        struct stat st;
+        if (fds[i] < 0 || fstat(fds[i], &st) != 0) return BUTTON_ERR_INVALID_ARG;
+        input->fds[i] = fds[i];
+        input->is_file[i] = S_ISREG(st.st_mode);
+        input->fd_flags[i] = -1;
+    }
+
+    if (use_io_uring && uring_setup(input)) {
+        input->backend = BUTTON_INPUT_BACKEND_IO_URING;
+        return BUTTON_OK;
+    }
+    if (epoll_setup(input)) {
+        input->backend = BUTTON_INPUT_BACKEND_EPOLL;
+        return BUTTON_OK;
+    }
+    return BUTTON_ERR_HW_FAIL;
+}
+
+button_error_t ButtonInput_SetDecoder(button_input_t* input, button_input_decode_fn decode) {
+    if (!input || !decode) return BUTTON_ERR_INVALID_ARG;
+
+    input->decode = decode;
+    return BUTTON_OK;
+}
+
+/* Never blocks. @p changed (optional) receives the number of inputs whose level changed. */
+button_error_t ButtonInput_Poll(button_input_t* input, uint16_t* changed) {
+    if (!input) return BUTTON_ERR_INVALID_ARG;
+
+    uint16_t n;
+    switch (input->backend) {
+        case BUTTON_INPUT_BACKEND_IO_URING:
+            n = uring_poll(input);
+            break;
+        case BUTTON_INPUT_BACKEND_EPOLL:
+            n = epoll_poll(input);
+            break;
+        default:
+            return BUTTON_ERR_NOT_INIT;
+    }
+    if (changed) *changed = n;
+    return BUTTON_OK;
+}
+
+bool ButtonInput_Level(const button_input_t* input, uint32_t index) {
+    if (!input || index >= input->count) return false;
+
+    return input->levels[index];
+}
+
+/*
+ * Reads still in flight are cancelled and their completions reaped before
+ * the ring is unmapped, so the kernel is done with the buffers when this
+ * returns. Descriptors stay open, with the flags they had before Open.
+ */
+button_error_t ButtonInput_Close(button_input_t* input) {
+    if (!input) return BUTTON_ERR_INVALID_ARG;
+
+    uring_cancel(input);
+    uring_teardown(input);
+    epoll_teardown(input);
+    input->backend = BUTTON_INPUT_BACKEND_NONE;
+    return BUTTON_OK;
+}
+
+static bool uring_setup(button_input_t* input) {
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+
+    int fd = (int)syscall(__NR_io_uring_setup, BUTTON_INPUT_MAX, &p);
+    if (fd < 0) return false;
+    input->ring_fd = fd;
+
+    input->sq_ring_size = p.sq_off.array + p.sq_entries * sizeof(unsigned int);
+    input->cq_ring_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        if (input->cq_ring_size > input->sq_ring_size) input->sq_ring_size = input->cq_ring_size;
+        input->cq_ring_size = input->sq_ring_size;
+    }
+
+    input->sq_ring = mmap(NULL, input->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (input->sq_ring == MAP_FAILED) {
+        input->sq_ring = NULL;
+        uring_teardown(input);
+        return false;
+    }
+    if (p.features & IORING_FEAT_SINGLE_MMAP) {
+        input->cq_ring = input->sq_ring;
+    } else {
+        input->cq_ring = mmap(NULL, input->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (input->cq_ring == MAP_FAILED) {
+            input->cq_ring = NULL;
+            uring_teardown(input);
+            return false;
+        }
+    }
+    input->sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+    input->sqes = mmap(NULL, input->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (input->sqes == MAP_FAILED) {
+        input->sqes = NULL;
+        uring_teardown(input);
+        return false;
+    }
+
+    uint8_t *sq = (uint8_t*)input->sq_ring;
+    uint8_t *cq = (uint8_t*)input->cq_ring;
+    input->sq_head = (unsigned int*)(sq + p.sq_off.head);
+    input->sq_tail = (unsigned int*)(sq + p.sq_off.tail);
+    input->sq_mask = (unsigned int*)(sq + p.sq_off.ring_mask);
+    input->sq_array = (unsigned int*)(sq + p.sq_off.array);
+    input->cq_head = (unsigned int*)(cq + p.cq_off.head);
+    input->cq_tail = (unsigned int*)(cq + p.cq_off.tail);
+    input->cq_mask = (unsigned int*)(cq + p.cq_off.ring_mask);
+    input->cqes = cq + p.cq_off.cqes;
+    return true;
+}
+
+static void uring_teardown(button_input_t* input) {
+    if (input->sqes) munmap(input->sqes, input->sqes_size);
+    if (input->cq_ring && input->cq_ring != input->sq_ring) munmap(input->cq_ring, input->cq_ring_size);
+    if (input->sq_ring) munmap(input->sq_ring, input->sq_ring_size);
+    if (input->ring_fd >= 0) close(input->ring_fd);
+    input->sqes = NULL;
+    input->cq_ring = NULL;
+    input->sq_ring = NULL;
+    input->ring_fd = -1;
+}
+
+/* Cancels every queued read and waits for its completion */
+static void uring_cancel(button_input_t* input) {
+    if (input->ring_fd < 0 || !input->sqes) return;
+
+    struct io_uring_sqe *sqes = (struct io_uring_sqe*)input->sqes;
+    unsigned int mask = *input->sq_mask;
+    unsigned int tail = *input->sq_tail;
+    unsigned int queued = 0;
+    unsigned int pending = 0;
+
+    for (uint16_t i = 0; i < input->count; i++) {
+        if (!input->in_flight[i]) continue;
+        unsigned int slot = tail & mask;
+        struct io_uring_sqe *sqe = &sqes[slot];
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->fd = -1;
+        sqe->addr = i;              /* user_data of the read */
+        sqe->user_data = BUTTON_INPUT_CANCEL_TAG | i;
+        input->sq_array[slot] = slot;
+        tail++;
+        queued++;
+        pending++;
+    }
+    if (pending == 0) return;
+    __atomic_store_n(input->sq_tail, tail, __ATOMIC_RELEASE);
+
+    /* A read that is already running (-EALREADY) still completes on its own */
+    while (pending > 0) {
+        int ret = (int)syscall(__NR_io_uring_enter, input->ring_fd, queued, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+        if (ret < 0 && errno != EINTR) break;
+        if (ret > 0) queued -= (unsigned int)ret;
+        uring_reap(input);
+        pending = 0;
+        for (uint16_t i = 0; i < input->count; i++) {
+            if (input->in_flight[i]) pending++;
+        }
+    }
+}
+
+/* One io_uring_enter: queues a read for every idle input and runs pending completions */
+static uint16_t uring_poll(button_input_t* input) {
+    struct io_uring_sqe *sqes = (struct io_uring_sqe*)input->sqes;
+    unsigned int mask = *input->sq_mask;
+    unsigned int first = *input->sq_tail;
+    unsigned int tail = first;
+    unsigned int queued = 0;
+    uint16_t order[BUTTON_INPUT_MAX];   /* Input of each queued read, in ring order */
+
+    for (uint16_t i = 0; i < input->count; i++) {
+        if (input->in_flight[i] || input->closed[i]) continue;
+        unsigned int slot = tail & mask;
+        struct io_uring_sqe *sqe = &sqes[slot];
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = input->fds[i];
+        sqe->addr = (uint64_t)(uintptr_t)input->bufs[i];
+        sqe->len = BUTTON_INPUT_BUF_SIZE;
+        sqe->off = (uint64_t)-1;    /* Current file position: streams and files alike */
+        sqe->user_data = i;
+        input->sq_array[slot] = slot;
+        input->in_flight[i] = true;
+        order[queued] = i;
+        tail++;
+        queued++;
+    }
+    __atomic_store_n(input->sq_tail, tail, __ATOMIC_RELEASE);
+
+    /* GETEVENTS without a minimum also runs the task work that posts finished reads */
+    int ret;
+    do {
+        ret = (int)syscall(__NR_io_uring_enter, input->ring_fd, queued, 0, IORING_ENTER_GETEVENTS, NULL, 0);
+    } while (ret < 0 && errno == EINTR);
+
+    /*
+     * Reads the kernel did not take (an error, or a short submit under memory
+     * pressure) come back off the ring: the kernel consumes in order and only
+     * inside io_uring_enter, so the tail can return to the first one. Their
+     * inputs are idle again and the next poll queues them anew.
+     */
+    unsigned int taken = (ret < 0) ? 0u : (unsigned int)ret;
+    if (taken < queued) {
+        __atomic_store_n(input->sq_tail, first + taken, __ATOMIC_RELEASE);
+        for (unsigned int q = taken; q < queued; q++) {
+            input->in_flight[order[q]] = false;
+        }
+    }
+
+    return uring_reap(input);
+}
+
+/* Applies posted completions; cancel requests only leave the ring */
+static uint16_t uring_reap(button_input_t* input) {
+    uint16_t changed = 0;
+    struct io_uring_cqe *cqes = (struct io_uring_cqe*)input->cqes;
+    unsigned int head = *input->cq_head;
+    unsigned int cq_tail = __atomic_load_n(input->cq_tail, __ATOMIC_ACQUIRE);
+    while (head != cq_tail) {
+        const struct io_uring_cqe *cqe = &cqes[head & *input->cq_mask];
+        uint64_t user_data = cqe->user_data;
+        int res = cqe->res;
+        head++;
+        if (user_data >= input->count) continue;
+        uint16_t i = (uint16_t)user_data;
+
+        input->in_flight[i] = false;
+        if (res > 0) {
+            if (apply_data(input, i, (size_t)res)) changed++;
+        } else if ((res == 0 && !input->is_file[i]) || (res < 0 && res != -EAGAIN && res != -EINTR)) {
+            input->closed[i] = true;
+        }
+    }
+    __atomic_store_n(input->cq_head, head, __ATOMIC_RELEASE);
+    return changed;
+}
+
+static bool epoll_setup(button_input_t* input) {
+    int ep = epoll_create1(EPOLL_CLOEXEC);
+    if (ep < 0) return false;
+
+    input->epoll_fd = ep;
+    for (uint16_t i = 0; i < input->count; i++) {
+        if (input->is_file[i]) continue;   /* Regular files are always readable and cannot be polled */
+        int flags = fcntl(input->fds[i], F_GETFL);
+        if (flags < 0) {
+            epoll_teardown(input);
+            return false;
+        }
+        if (!(flags & O_NONBLOCK)) {
+            if (fcntl(input->fds[i], F_SETFL, flags | O_NONBLOCK) != 0) {
+                epoll_teardown(input);
+                return false;
+            }
+            input->fd_flags[i] = flags;
+        }
+        struct epoll_event ev = { .events = EPOLLIN, .data.u32 = i };
+        if (epoll_ctl(ep, EPOLL_CTL_ADD, input->fds[i], &ev) != 0) {
+            epoll_teardown(input);
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Gives the descriptors back as they were before epoll_setup */
+static void epoll_teardown(button_input_t* input) {
+    for (uint16_t i = 0; i < input->count; i++) {
+        if (input->fd_flags[i] < 0) continue;
+        fcntl(input->fds[i], F_SETFL, input->fd_flags[i]);
+        input->fd_flags[i] = -1;
+    }
+    if (input->epoll_fd >= 0) close(input->epoll_fd);
+    input->epoll_fd = -1;
+}
+
+static uint16_t epoll_poll(button_input_t* input) {
+    struct epoll_event events[BUTTON_INPUT_MAX];
+    uint16_t changed = 0;
+
+    int n = epoll_wait(input->epoll_fd, events, BUTTON_INPUT_MAX, 0);
+    for (int e = 0; e < n; e++) {
+        uint16_t i = (uint16_t)events[e].data.u32;
+        if (i < input->count && !input->closed[i] && read_input(input, i)) changed++;
+    }
+    for (uint16_t i = 0; i < input->count; i++) {
+        if (input->is_file[i] && !input->closed[i] && read_input(input, i)) changed++;
+    }
+    return changed;
+}
+
+/* Drains what is available now; the last level read wins */
+static bool read_input(button_input_t* input, uint16_t i) {
+    bool before = input->levels[i];
+
+    for (;;) {
+        ssize_t r = read(input->fds[i], input->bufs[i], BUTTON_INPUT_BUF_SIZE);
+        if (r > 0) {
+            apply_data(input, i, (size_t)r);
+            if ((size_t)r < BUTTON_INPUT_BUF_SIZE) break;
+            continue;
+        }
+        if (r < 0 && errno == EINTR) continue;
+        if ((r == 0 && !input->is_file[i]) || (r < 0 && errno != EAGAIN)) {
+            input->closed[i] = true;
+            if (input->epoll_fd >= 0) epoll_ctl(input->epoll_fd, EPOLL_CTL_DEL, input->fds[i], NULL);
+        }
+        break;
+    }
+    return input->levels[i] != before;
+}
+
+static bool apply_data(button_input_t* input, uint16_t i, size_t len) {
+    bool level = input->decode(input->bufs[i], len, input->levels[i]);
+    if (level == input->levels[i]) return false;
+
+    input->levels[i] = level;
+    return true;
+}
+
+static bool decode_level(const uint8_t* data, size_t len, bool level) {
+    while (len > 0) {
+        uint8_t b = data[--len];
+        if (b == '\n' || b == '\r' || b == ' ' || b == '\t') continue;
+        return b != 0 && b != '0';
+    }
+    return level;
+}
@@ -0,0 +1,142 @@
+#define     _GNU_SOURCE
+#include    <stdbool.h>
+#include    <stdint.h>
+#include    <stddef.h>
+#include    <string.h>
+#include    <errno.h>
+#include    <fcntl.h>
+#include    <unistd.h>
+#include    <sched.h>
+#include    <sys/mman.h>
+#include    <sys/stat.h>
+#include    "button_monitor.h"
+
+
+/*
+ * Creates the shared page @p name ("/buttons-panel0") for @p count buttons.
+ * Fails if the name is taken, since another publisher may still be live on
+ * it; @p take_over removes the existing page first, for a publisher that
+ * knows it owns the name (e.g. restarted by its supervisor). Readers of a
+ * removed page keep their mapping and see its tick stop. Hand map->page to
+ * Button_BankConfigMonitor; the page is not valid for readers before that.
+ */
+button_error_t ButtonMonitor_Create(button_monitor_map_t* map, const char* name, uint16_t count, bool take_over) {
+    if (!map || !name || name[0] != '/' || count == 0) return BUTTON_ERR_INVALID_ARG;
+
+    *map = (button_monitor_map_t){ .page = NULL, .size = BUTTON_MONITOR_PAGE_SIZE(count) };
+
+    if (take_over) shm_unlink(name);
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (fd < 0) return BUTTON_ERR_HW_FAIL;
+    if (ftruncate(fd, (off_t)map->size) != 0) {
+        close(fd);
+        shm_unlink(name);
+        return BUTTON_ERR_HW_FAIL;
+    }
+
+    void *p = mmap(NULL, map->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) {
+        shm_unlink(name);
+        return BUTTON_ERR_HW_FAIL;
+    }
+    map->page = (button_monitor_page_t*)p;
+    return BUTTON_OK;
+}
+
+/*
+ * Maps an existing page read-only. BUTTON_ERR_NOT_INIT: the publisher has not
+ * configured it yet, try again later. A page whose tick stops advancing was
+ * replaced or abandoned by its publisher: close and attach again.
+ */
+button_error_t ButtonMonitor_Attach(button_monitor_map_t* map, const char* name) {
+    struct stat st;
+    if (!map || !name) return BUTTON_ERR_INVALID_ARG;
+
+    *map = (button_monitor_map_t){ .page = NULL, .size = 0 };
+
+    int fd = shm_open(name, O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0) return BUTTON_ERR_HW_FAIL;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(button_monitor_page_t)) {
+        close(fd);
+        return BUTTON_ERR_NOT_INIT;
+    }
+
+    size_t size = (size_t)st.st_size;
+    void *p = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return BUTTON_ERR_HW_FAIL;
+
+    const button_monitor_page_t *page = (const button_monitor_page_t*)p;
+    if (page->magic != BUTTON_MONITOR_MAGIC || page->version != BUTTON_MONITOR_VERSION ||
+        BUTTON_MONITOR_PAGE_SIZE(page->count) > size) {
+        munmap(p, size);
+        return BUTTON_ERR_NOT_INIT;
+    }
+    atomic_thread_fence(memory_order_acquire);
+
+    map->page = (button_monitor_page_t*)p;
+    map->size = size;
+    return BUTTON_OK;
+}
+
+/*
+ * Copies slots [first, first + n) as they were between two sweeps, and the
+ * tick of the last sweep (@p tick, optional). Never blocks the writer and
+ * makes no syscall unless it finds a sweep in progress. BUTTON_ERR_UNKNOWN
+ * when every retry overlapped a sweep, i.e. the writer stalled in one.
+ */
+button_error_t ButtonMonitor_Read(const button_monitor_page_t* page, uint16_t first, uint16_t n,
+                                  button_monitor_sample_t* samples, uint32_t* tick) {
+    if (!page || (n > 0 && !samples)) return BUTTON_ERR_INVALID_ARG;
+    if (page->magic != BUTTON_MONITOR_MAGIC) return BUTTON_ERR_NOT_INIT;
+    if ((uint32_t)first + n > page->count) return BUTTON_ERR_INVALID_ARG;
+
+    for (uint32_t attempt = 0; attempt < BUTTON_MONITOR_READ_RETRIES; attempt++) {
+        uint32_t seq = (uint32_t)atomic_load_explicit(&page->seq, memory_order_acquire);
+        if (seq & 1u) {
+            /* The writer may be preempted mid-sweep: spinning on its core would only delay it */
+            sched_yield();
+            continue;
+        }
+
+        for (uint16_t i = 0; i < n; i++) {
+            const button_monitor_slot_t *slot = &page->slots[first + i];
+            uint32_t status = (uint32_t)atomic_load_explicit(&slot->status, memory_order_relaxed);
+            samples[i].state = BUTTON_MONITOR_STATE(status);
+            samples[i].last_event = BUTTON_MONITOR_EVENT(status);
+            samples[i].press_start_tick = (uint32_t)atomic_load_explicit(&slot->press_start_tick, memory_order_relaxed);
+            samples[i].last_event_tick = (uint32_t)atomic_load_explicit(&slot->last_event_tick, memory_order_relaxed);
+        }
+        uint32_t at = (uint32_t)atomic_load_explicit(&page->tick, memory_order_relaxed);
+        atomic_thread_fence(memory_order_acquire);
+
+        if (seq == (uint32_t)atomic_load_explicit(&page->seq, memory_order_relaxed)) {
+            if (tick) *tick = at;
+            return BUTTON_OK;
+        }
+    }
+    return BUTTON_ERR_UNKNOWN;
+}
+
+/* Unmaps the page; a publisher's page stays visible under its name until ButtonMonitor_Unlink or a Create that takes it over */
+button_error_t ButtonMonitor_Close(button_monitor_map_t* map) {
+    if (!map) return BUTTON_ERR_INVALID_ARG;
+
+    if (map->page) munmap(map->page, map->size);
+    map->page = NULL;
+    map->size = 0;
+    return BUTTON_OK;
+}
+
+/*
+ * Removes the name of a page, for its publisher on shutdown. Mappings stay
+ * valid until closed, so readers see the tick stop; new Attach calls fail.
+ * BUTTON_ERR_NOT_INIT when no page has that name (errno ENOENT).
+ */
+button_error_t ButtonMonitor_Unlink(const char* name) {
+    if (!name || name[0] != '/') return BUTTON_ERR_INVALID_ARG;
+
+    if (shm_unlink(name) != 0) return (errno == ENOENT) ? BUTTON_ERR_NOT_INIT : BUTTON_ERR_HW_FAIL;
+    return BUTTON_OK;
+}
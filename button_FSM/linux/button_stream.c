@@ -0,0 +1,253 @@
+#define     _GNU_SOURCE
+#include    <stdbool.h>
+#include    <stdint.h>
+#include    <stddef.h>
+#include    <string.h>
+#include    <errno.h>
+#include    <unistd.h>
+#include    <sys/socket.h>
+#include    <sys/stat.h>
+#include    <sys/un.h>
+#include    "button_stream.h"
+
+static bool make_address(struct sockaddr_un* addr, const char* path);
+static bool remove_stale_socket(const struct sockaddr_un* addr);
+static void put_u16(uint8_t* p, uint16_t v);
+static void put_u32(uint8_t* p, uint32_t v);
+static uint16_t get_u16(const uint8_t* p);
+static uint32_t get_u32(const uint8_t* p);
+static void accept_clients(button_stream_pub_t* pub);
+static void drop_client(button_stream_pub_t* pub, uint8_t slot);
+
+_Static_assert(BUTTON_STREAM_PATH_MAX == sizeof(((struct sockaddr_un*)0)->sun_path), "path buffer must match sun_path");
+
+
+/*
+ * Binds @p path, replacing a socket left by a previous run. Anything else at
+ * the path, or a socket a live publisher still accepts on, is left alone and
+ * fails with BUTTON_ERR_HW_FAIL. Close removes the path again.
+ */
+button_error_t ButtonStream_Open(button_stream_pub_t* pub, const char* path) {
+    struct sockaddr_un addr;
+    if (!pub || !path || !make_address(&addr, path)) return BUTTON_ERR_INVALID_ARG;
+
+    *pub = (button_stream_pub_t){ .listen_fd = -1 };
+
+    if (!remove_stale_socket(&addr)) return BUTTON_ERR_HW_FAIL;
+
+    int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return BUTTON_ERR_HW_FAIL;
+
+    if (bind(fd, (const struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return BUTTON_ERR_HW_FAIL;
+    }
+    if (listen(fd, BUTTON_STREAM_MAX_CLIENTS) != 0) {
+        close(fd);
+        unlink(path);
+        return BUTTON_ERR_HW_FAIL;
+    }
+    memcpy(pub->path, addr.sun_path, sizeof(pub->path));
+    pub->listen_fd = fd;
+    return BUTTON_OK;
+}
+
+/* Bank handler: appends the event to the frame of the current sweep */
+void ButtonStream_OnEvent(uint16_t index, button_event_t event, void* context) {
+    button_stream_pub_t *pub = (button_stream_pub_t*)context;
+    if (!pub) return;
+
+    if (pub->event_count >= BUTTON_STREAM_MAX_EVENTS) {
+        pub->truncated = true;
+        return;
+    }
+    uint8_t *rec = &pub->frame[BUTTON_STREAM_HEADER_SIZE + (uint32_t)pub->event_count * BUTTON_STREAM_RECORD_SIZE];
+    put_u16(rec, index);
+    rec[2] = (uint8_t)event;
+    rec[3] = 0;
+    pub->event_count++;
+}
+
+/*
+ * Call once after each sweep. Clients waiting in the listen backlog are
+ * accepted on every call, so a quiet bank does not leave them in the backlog
+ * (where they count against it); a quiet sweep costs that one accept and
+ * sends nothing. A client whose queue is full misses the frame (counted in
+ * dropped_frames) rather than stalling the scanner.
+ */
+button_error_t ButtonStream_Flush(button_stream_pub_t* pub, uint32_t tick) {
+    if (!pub) return BUTTON_ERR_INVALID_ARG;
+    if (pub->listen_fd < 0) return BUTTON_ERR_NOT_INIT;
+
+    accept_clients(pub);
+    if (pub->event_count == 0 && !pub->truncated) return BUTTON_OK;
+
+    uint8_t *h = pub->frame;
+    h[0] = 'B';
+    h[1] = 'S';
+    h[2] = BUTTON_STREAM_VERSION;
+    h[3] = pub->truncated ? BUTTON_STREAM_FLAG_TRUNCATED : 0u;
+    put_u32(&h[4], pub->sequence);
+    put_u32(&h[8], tick);
+    put_u16(&h[12], pub->event_count);
+    put_u16(&h[14], 0);
+    size_t len = BUTTON_STREAM_HEADER_SIZE + (size_t)pub->event_count * BUTTON_STREAM_RECORD_SIZE;
+
+    for (uint8_t c = 0; c < pub->client_count; ) {
+        ssize_t n = send(pub->clients[c], pub->frame, len, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n == (ssize_t)len) {
+            c++;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            pub->dropped_frames++;
+            c++;
+        } else {
+            drop_client(pub, c);
+        }
+    }
+
+    pub->sequence++;
+    pub->event_count = 0;
+    pub->truncated = false;
+    return BUTTON_OK;
+}
+
+button_error_t ButtonStream_Close(button_stream_pub_t* pub) {
+    if (!pub) return BUTTON_ERR_INVALID_ARG;
+
+    while (pub->client_count > 0) {
+        drop_client(pub, 0);
+    }
+    if (pub->listen_fd >= 0) {
+        close(pub->listen_fd);
+        unlink(pub->path);
+    }
+    pub->listen_fd = -1;
+    return BUTTON_OK;
+}
+
+button_error_t ButtonStream_Connect(button_stream_client_t* client, const char* path) {
+    struct sockaddr_un addr;
+    if (!client || !path || !make_address(&addr, path)) return BUTTON_ERR_INVALID_ARG;
+
+    *client = (button_stream_client_t){ .fd = -1 };
+
+    int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (fd < 0) return BUTTON_ERR_HW_FAIL;
+    if (connect(fd, (const struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return BUTTON_ERR_HW_FAIL;
+    }
+    client->fd = fd;
+    return BUTTON_OK;
+}
+
+/*
+ * Blocks for the next frame and decodes up to @p max_events of it. @p count
+ * receives the number decoded; extra events in the frame are skipped.
+ */
+button_error_t ButtonStream_Receive(button_stream_client_t* client, button_stream_event_t* events, uint16_t max_events,
+                                    uint16_t* count, uint32_t* tick, uint8_t* flags) {
+    uint8_t frame[BUTTON_STREAM_MAX_FRAME];
+    if (!client || !count || (max_events > 0 && !events)) return BUTTON_ERR_INVALID_ARG;
+    if (client->fd < 0) return BUTTON_ERR_NOT_INIT;
+
+    ssize_t n;
+    do {
+        n = recv(client->fd, frame, sizeof(frame), 0);
+    } while (n < 0 && errno == EINTR);
+    if (n <= 0) return BUTTON_ERR_HW_FAIL;
+    if ((size_t)n < BUTTON_STREAM_HEADER_SIZE || frame[0] != 'B' || frame[1] != 'S' || frame[2] != BUTTON_STREAM_VERSION) {
+        return BUTTON_ERR_UNKNOWN;
+    }
+
+    uint16_t total = get_u16(&frame[12]);
+    if ((size_t)n < BUTTON_STREAM_HEADER_SIZE + (size_t)total * BUTTON_STREAM_RECORD_SIZE) return BUTTON_ERR_UNKNOWN;
+
+    uint32_t sequence = get_u32(&frame[4]);
+    if (client->has_sequence && sequence != client->last_sequence + 1u) {
+        client->lost_frames += sequence - client->last_sequence - 1u;
+    }
+    client->last_sequence = sequence;
+    client->has_sequence = true;
+
+    uint16_t decoded = (total < max_events) ? total : max_events;
+    for (uint16_t i = 0; i < decoded; i++) {
+        const uint8_t *rec = &frame[BUTTON_STREAM_HEADER_SIZE + (uint32_t)i * BUTTON_STREAM_RECORD_SIZE];
+        events[i].index = get_u16(rec);
+        events[i].event = (button_event_t)rec[2];
+    }
+    *count = decoded;
+    if (tick) *tick = get_u32(&frame[8]);
+    if (flags) *flags = frame[3];
+    return BUTTON_OK;
+}
+
+button_error_t ButtonStream_Disconnect(button_stream_client_t* client) {
+    if (!client) return BUTTON_ERR_INVALID_ARG;
+
+    if (client->fd >= 0) close(client->fd);
+    client->fd = -1;
+    return BUTTON_OK;
+}
+
+static bool make_address(struct sockaddr_un* addr, const char* path) {
+    size_t len = strlen(path);
+    if (len == 0 || len >= sizeof(addr->sun_path)) return false;
+
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    memcpy(addr->sun_path, path, len + 1);
+    return true;
+}
+
+/* False when the path is taken by something that is not a dead socket */
+static bool remove_stale_socket(const struct sockaddr_un* addr) {
+    struct stat st;
+    if (lstat(addr->sun_path, &st) != 0) return errno == ENOENT;
+    if (!S_ISSOCK(st.st_mode)) return false;
+
+    int probe = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (probe < 0) return false;
+    bool live = connect(probe, (const struct sockaddr*)addr, sizeof(*addr)) == 0 || errno != ECONNREFUSED;
+    close(probe);
+    if (live) return false;
+
+    return unlink(addr->sun_path) == 0;
+}
+
+static void accept_clients(button_stream_pub_t* pub) {
+    for (;;) {
+        int fd = accept4(pub->listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;
+        if (pub->client_count >= BUTTON_STREAM_MAX_CLIENTS) {
+            close(fd);
+            continue;
+        }
+        pub->clients[pub->client_count++] = fd;
+    }
+}
+
+static void drop_client(button_stream_pub_t* pub, uint8_t slot) {
+    close(pub->clients[slot]);
+    pub->clients[slot] = pub->clients[--pub->client_count];
+}
+
+static void put_u16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static uint16_t get_u16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
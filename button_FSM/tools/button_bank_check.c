@@ -0,0 +1,551 @@
+/**
+ * @file    button_bank_check.c
+ * @author  datngyB
+ * @brief   Bank enable masks, suspend/resume, scan groups and power-on held buttons against per-button references.
+ * @version 0.1.0
+ * @date    2026-10-18
+ * * @copyright Copyright (c) 2026
+ *
+ * Each run drives a bank and one button_t reference per button with the same
+ * panel workload (button_workload.h) and compares them after every sweep:
+ * the events dispatched, and each button's state and last change tick.
+ *   - masks: between sweeps random buttons are disabled and enabled again.
+ *     A button whose enable bit changed is parked on the next sweep: the
+ *     reference dispatches RELEASED if it was PRESSED or LONG_PRESSED, then
+ *     is initialised again at that sweep's tick. Disabled references are not
+ *     updated;
+ *   - suspend: the bank is suspended and resumed at random. References skip
+ *     the paused sweeps and run on a clock that excludes every pause, so the
+ *     debounce and long-press countdowns of the bank must continue where
+ *     they stopped, shifted by the pause length;
+ *   - groups: a second pass spreads the buttons over CHECK_GROUPS scan groups
+ *     with random periods (the first sometimes 0) and sweeps either at
+ *     Button_BankNextDue or at random ticks. A reference is updated only when
+ *     its group is due: every period on the pause-free clock, or one period
+ *     after a sweep that found it late. The pins read by each sweep must be
+ *     those of the due groups, and after a running sweep NextDue must be the
+ *     earliest due tick. Masks and suspend stay active in this pass;
+ *   - held: a random half of the buttons is pressed at init, then released
+ *     one at a time. The bank runs Button_BankDetectHeld and the references
+ *     Button_InitEx with detect_held, once with a back-date shorter than the
+ *     long press and once with a longer one. Each held button must dispatch
+ *     POWER_ON_HELD on the first sweep and never PRESSED, and LONG_PRESSED
+ *     on the first sweep at least long_press_ticks after the back-dated
+ *     press (the first sweep itself when the back-date covers it).
+ *
+ * Without dispatch the sweep's event set and count are compared instead of
+ * the event sequence.
+ *
+ * Usage: button_bank_check [-n runs] [-s seed]
+ * Build: cc -O2 -Iinclude -Itools button_static.c button_bank.c button_latency.c tools/button_bank_check.c tools/button_workload.c -lm
+ * Exit status is non-zero on the first mismatch.
+ */
+
+#include    <stdbool.h>
+#include    <stdint.h>
+#include    <stdio.h>
+#include    <stdlib.h>
+#include    <string.h>
+#include    "button_bank.h"
+#include    "button_workload.h"
+
+#define CHECK_BUTTONS               40u     /* Two mask words */
+#define CHECK_DURATION              200000u
+#define CHECK_SCAN_TICKS            5u
+#define CHECK_MAX_EVENTS            128u    /* Per sweep */
+#define CHECK_TOGGLE_PERCENT        10u     /* Chance per sweep of an enable or disable */
+#define CHECK_SUSPEND_PERMILLE      3u      /* Chance per sweep of a suspend while running */
+#define CHECK_RESUME_PERMILLE       25u     /* Chance per sweep of a resume while suspended */
+#define CHECK_GROUPS                4u
+#define CHECK_MAX_PERIOD            40u     /* Group periods drawn in [1, CHECK_MAX_PERIOD] */
+#define CHECK_MAX_GAP               12u     /* Sweeps not at NextDue come 1..CHECK_MAX_GAP ticks apart */
+#define CHECK_HELD_START            100000u /* Init tick of the held part */
+
+#if BUTTON_FEATURE_STAGES
+static const button_stage_config_t check_stages[] = {
+    { 2000u, BUTTON_EVENT_SUPER_LONG_PRESSED, 0 },
+};
+#define CHECK_STAGE_COUNT           ((uint8_t)(sizeof(check_stages) / sizeof(check_stages[0])))
+#else
+#define check_stages                NULL
+#define CHECK_STAGE_COUNT           0u
+#endif
+
+/* Events of one sweep, in dispatch order */
+typedef struct {
+    uint16_t index[CHECK_MAX_EVENTS];
+    button_event_t event[CHECK_MAX_EVENTS];
+    uint32_t count;
+    button_event_mask_t mask;
+} check_log_t;
+
+typedef struct {
+    uint32_t sweeps;
+    uint32_t toggles;
+    uint32_t released;      /* Restarts that released a reported press */
+    uint32_t pauses;
+    uint32_t paused_presses; /* Pauses that ended with a press in progress */
+    uint32_t next_due;      /* Sweeps scheduled at Button_BankNextDue */
+    uint32_t idle_sweeps;   /* Running sweeps with no group due */
+    uint32_t held;          /* Buttons pressed at init */
+    uint32_t held_long;     /* Of which LONG_PRESSED on the first sweep */
+} check_stats_t;
+
+static button_profile_t profile;
+static button_bank_entry_t entries[CHECK_BUTTONS];
+static button_bank_state_t states[CHECK_BUTTONS];
+static button_bank_mask_t enabled_mask[BUTTON_BANK_MASK_WORDS(CHECK_BUTTONS)];
+static button_bank_mask_t restart_mask[BUTTON_BANK_MASK_WORDS(CHECK_BUTTONS)];
+static button_scan_group_t groups[CHECK_GROUPS];
+static uint32_t group_members[CHECK_GROUPS * BUTTON_BANK_MASK_WORDS(CHECK_BUTTONS)];
+static button_bank_t bank;
+static bool levels[CHECK_BUTTONS];
+static uint32_t sweep_tick;
+static uint32_t bank_reads;
+static check_log_t bank_log;
+
+/* References and their model of the bank controls */
+static button_t refs[CHECK_BUTTONS];
+#if BUTTON_FEATURE_STAGES
+static bool ref_latches[CHECK_BUTTONS][1];
+#endif
+static bool ref_enabled[CHECK_BUTTONS];
+static bool ref_restart[CHECK_BUTTONS];
+static bool ref_suspended;
+static bool ref_paused;
+static uint32_t ref_pause_tick;
+static uint32_t ref_shift;      /* Ticks spent paused so far */
+static uint32_t ref_tick;       /* Sweep tick less ref_shift */
+static bool ref_grouped;
+static uint32_t ref_due[CHECK_GROUPS];  /* Next sampling tick of each group, pause-free clock */
+static uint32_t ref_reads;
+static check_log_t ref_log;
+static uint32_t rng_state;
+
+static uint32_t check_rand(void);
+static bool check_read_pin(uint32_t gpio_num);
+static uint32_t check_get_tick(void);
+static bool ref_read_pin(uint32_t gpio_num);
+static uint32_t ref_get_tick(void);
+static void log_event(check_log_t* log, uint16_t index, button_event_t event);
+#if BUTTON_FEATURE_DISPATCH
+static void bank_event(uint16_t index, button_event_t event, void* context);
+static void ref_event(button_event_t event, void* context);
+#endif
+static bool ref_init(uint16_t index, const button_init_config_t* config);
+static bool bank_open(bool grouped, uint32_t start);
+static uint32_t ref_due_groups(void);
+static void ref_sweep(uint32_t tick, check_stats_t* stats);
+static bool sweep_both(uint32_t seed, uint32_t tick, check_stats_t* stats);
+static void toggle_controls(check_stats_t* stats);
+static bool drive(uint32_t seed, bool grouped, check_stats_t* stats);
+static uint32_t first_sweep_after(uint32_t tick);
+static bool held_at_init(uint32_t seed, uint32_t backdate, check_stats_t* stats);
+static bool run_one(uint32_t seed);
+
+
+static uint32_t check_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static bool check_read_pin(uint32_t gpio_num) {
+    bank_reads++;
+    return levels[gpio_num];
+}
+
+static uint32_t check_get_tick(void) {
+    return sweep_tick;
+}
+
+static bool ref_read_pin(uint32_t gpio_num) {
+    ref_reads++;
+    return levels[gpio_num];
+}
+
+static uint32_t ref_get_tick(void) {
+    return ref_tick;
+}
+
+static void log_event(check_log_t* log, uint16_t index, button_event_t event) {
+    if (log->count < CHECK_MAX_EVENTS) {
+        log->index[log->count] = index;
+        log->event[log->count] = event;
+    }
+    log->count++;
+    log->mask |= BUTTON_EVENT_BIT(event);
+}
+
+#if BUTTON_FEATURE_DISPATCH
+static void bank_event(uint16_t index, button_event_t event, void* context) {
+    (void)context;
+    log_event(&bank_log, index, event);
+}
+
+static void ref_event(button_event_t event, void* context) {
+    log_event(&ref_log, (uint16_t)(uintptr_t)context, event);
+}
+#endif
+
+static bool ref_init(uint16_t index, const button_init_config_t* config) {
+    if (Button_InitEx(&refs[index], index, BUTTON_ACTIVE_HIGH, ref_read_pin, ref_get_tick, config) != BUTTON_OK) return false;
+#if BUTTON_FEATURE_STAGES
+    ref_latches[index][0] = false;
+    if (Button_ConfigStages(&refs[index], check_stages, ref_latches[index], CHECK_STAGE_COUNT) != BUTTON_OK) return false;
+#endif
+#if BUTTON_FEATURE_DISPATCH
+    Button_RegisterHandler(&refs[index], ref_event, (void*)(uintptr_t)index);
+#endif
+    return true;
+}
+
+static bool bank_open(bool grouped, uint32_t start) {
+    memset(levels, 0, sizeof(levels));
+    memset(entries, 0, sizeof(entries));
+    for (uint16_t i = 0; i < CHECK_BUTTONS; i++) {
+        entries[i].gpio_num = i;
+        entries[i].active_level = BUTTON_ACTIVE_HIGH;
+        if (grouped) entries[i].group = (uint8_t)(check_rand() % CHECK_GROUPS);
+    }
+    for (uint8_t g = 0; g < CHECK_GROUPS; g++) {
+        groups[g].period_ticks = 1u + check_rand() % CHECK_MAX_PERIOD;
+        ref_due[g] = start;
+    }
+    if (check_rand() % 4u == 0) groups[0].period_ticks = 0;
+    profile = (button_profile_t)BUTTON_PROFILE_DEFAULT(check_stages, CHECK_STAGE_COUNT);
+    sweep_tick = start;
+    if (Button_BankInit(&bank, entries, states, CHECK_BUTTONS, &profile, 1, check_read_pin, check_get_tick) != BUTTON_OK) return false;
+    if (Button_BankConfigMasks(&bank, enabled_mask, restart_mask) != BUTTON_OK) return false;
+    if (grouped && Button_BankConfigGroups(&bank, groups, CHECK_GROUPS, group_members) != BUTTON_OK) return false;
+#if BUTTON_FEATURE_DISPATCH
+    if (Button_BankRegisterHandler(&bank, bank_event, NULL) != BUTTON_OK) return false;
+#endif
+
+    ref_tick = start;
+    ref_shift = 0;
+    ref_suspended = false;
+    ref_paused = false;
+    ref_grouped = grouped;
+    for (uint16_t i = 0; i < CHECK_BUTTONS; i++) {
+        ref_enabled[i] = true;
+        ref_restart[i] = false;
+        if (!ref_init(i, NULL)) return false;
+    }
+    return true;
+}
+
+/* Bit g set when group g is due at ref_tick */
+static uint32_t ref_due_groups(void) {
+    uint32_t due = 0;
+
+    for (uint8_t g = 0; g < CHECK_GROUPS; g++) {
+        if ((int32_t)(ref_tick - ref_due[g]) < 0) continue;
+        due |= 1u << g;
+        uint32_t next = ref_due[g] + groups[g].period_ticks;
+        ref_due[g] = ((int32_t)(ref_tick - next) < 0) ? next : ref_tick + groups[g].period_ticks;
+    }
+    return due;
+}
+
+/* What the bank is expected to do on a sweep at @p tick */
+static void ref_sweep(uint32_t tick, check_stats_t* stats) {
+    if (ref_suspended) {
+        if (!ref_paused) {
+            ref_paused = true;
+            ref_pause_tick = tick;
+        }
+        return;
+    }
+    if (ref_paused) {
+        ref_paused = false;
+        ref_shift += tick - ref_pause_tick;
+        for (uint16_t i = 0; i < CHECK_BUTTONS; i++) {
+            if (refs[i].last_state != STATE_IDLE) {
+                stats->paused_presses++;
+                break;
+            }
+        }
+    }
+    ref_tick = tick - ref_shift;
+
+    /* Parked buttons first, in index order, then the enabled ones are sampled */
+    for (uint16_t i = 0; i < CHECK_BUTTONS; i++) {
+        if (!ref_restart[i]) continue;
+        ref_restart[i] = false;
+        if (refs[i].last_state == STATE_PRESSED || refs[i].last_state == STATE_LONG_PRESSED) {
+            log_event(&ref_log, i, BUTTON_EVENT_RELEASED);
+            stats->released++;
+        }
+        ref_init(i, NULL);
+    }
+    uint32_t due = ref_grouped ? ref_due_groups() : 0xFFFFFFFFu;
+    if (due == 0) stats->idle_sweeps++;
+    for (uint16_t i = 0; i < CHECK_BUTTONS; i++) {
+        if (!ref_enabled[i] || !(due & (1u << entries[i].group))) continue;
+#if BUTTON_FEATURE_DISPATCH
+        Button_Update(&refs[i]);
+#else
+        button_event_mask_t events = 0;
+        Button_UpdateEx(&refs[i], &events);
+        for (button_event_t e = BUTTON_EVENT_PRESSED; e < BUTTON_EVENT_MAX; e++) {
+            if (events & BUTTON_EVENT_BIT(e)) log_event(&ref_log, i, e);
+        }
+#endif
+    }
+}
+
+static bool sweep_both(uint32_t seed, uint32_t tick, check_stats_t* stats) {
+    button_event_mask_t events = 0;
+    uint32_t count = 0;
+
+    memset(&bank_log, 0, sizeof(bank_log));
+    memset(&ref_log, 0, sizeof(ref_log));
+    bank_reads = 0;
+    ref_reads = 0;
+    sweep_tick = tick;
+    Button_BankUpdateEx(&bank, &events, &count);
+    ref_sweep(tick, stats);
+    stats->sweeps++;
+
+    if (bank_reads != ref_reads) {
+        printf("FAIL seed 0x%08lx: tick %lu, sweep read %lu pins, expected %lu\n", (unsigned long)seed,
+               (unsigned long)tick, (unsigned long)bank_reads, (unsigned long)ref_reads);
+        return false;
+    }
+    if (ref_grouped && !ref_paused) {
+        uint32_t next = 0;
+        uint32_t expected = ref_due[0];
+        for (uint8_t g = 1; g < CHECK_GROUPS; g++) {
+            if ((int32_t)(ref_due[g] - expected) < 0) expected = ref_due[g];
+        }
+        expected += ref_shift;
+        if (Button_BankNextDue(&bank, &next) != BUTTON_OK || next != expected) {
+            printf("FAIL seed 0x%08lx: tick %lu, next due %lu, expected %lu\n", (unsigned long)seed,
+                   (unsigned long)tick, (unsigned long)next, (unsigned long)expected);
+            return false;
+        }
+    }
+    if (events != ref_log.mask || count != ref_log.count) {
+        printf("FAIL seed 0x%08lx: tick %lu, bank dispatched %lu events (set 0x%04x), expected %lu (set 0x%04x)\n",
+               (unsigned long)seed, (unsigned long)tick, (unsigned long)count, (unsigned)events,
+               (unsigned long)ref_log.count, (unsigned)ref_log.mask);
+        return false;
+    }
+#if BUTTON_FEATURE_DISPATCH
+    if (bank_log.count != ref_log.count) {
+        printf("FAIL seed 0x%08lx: tick %lu, handler saw %lu events, expected %lu\n", (unsigned long)seed,
+               (unsigned long)tick, (unsigned long)bank_log.count, (unsigned long)ref_log.count);
+        return false;
+    }
+    for (uint32_t e = 0; e < ref_log.count && e < CHECK_MAX_EVENTS; e++) {
+        if (bank_log.index[e] != ref_log.index[e] || bank_log.event[e] != ref_log.event[e]) {
+            printf("FAIL seed 0x%08lx: tick %lu, event %lu is button %u event %d, expected button %u event %d\n",
+                   (unsigned long)seed, (unsigned long)tick, (unsigned long)e, (unsigned)bank_log.index[e],
+                   (int)bank_log.event[e], (unsigned)ref_log.index[e], (int)ref_log.event[e]);
+            return false;
+        }
+    }
+#endif
+    for (uint16_t i = 0; i < CHECK_BUTTONS; i++) {
+        if (states[i].state != (uint8_t)refs[i].last_state ||
+            states[i].last_change_tick != refs[i].last_change_tick + ref_shift) {
+            printf("FAIL seed 0x%08lx: tick %lu, button %u in state %u since %lu, expected state %u since %lu\n",
+                   (unsigned long)seed, (unsigned long)tick, (unsigned)i, (unsigned)states[i].state,
+                   (unsigned long)states[i].last_change_tick, (unsigned)refs[i].last_state,
+                   (unsigned long)(refs[i].last_change_tick + ref_shift));
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Between two sweeps: maybe flip one enable bit, maybe suspend or resume */
+static void toggle_controls(check_stats_t* stats) {
+    if (check_rand() % 100u < CHECK_TOGGLE_PERCENT) {
+        uint16_t i = (uint16_t)(check_rand() % CHECK_BUTTONS);
+        if (check_rand() & 1u) {
+            Button_BankEnable(&bank, i);
+            if (!ref_enabled[i]) ref_restart[i] = true;
+            ref_enabled[i] = true;
+        } else {
+            Button_BankDisable(&bank, i);
+            if (ref_enabled[i]) ref_restart[i] = true;
+            ref_enabled[i] = false;
+        }
+        stats->toggles++;
+    }
+    if (!ref_suspended && check_rand() % 1000u < CHECK_SUSPEND_PERMILLE) {
+        Button_BankSuspend(&bank);
+        ref_suspended = true;
+        stats->pauses++;
+    } else if (ref_suspended && check_rand() % 1000u < CHECK_RESUME_PERMILLE) {
+        Button_BankResume(&bank);
+        ref_suspended = false;
+    }
+}
+
+/* Grouped passes sweep at NextDue or after a random gap; the others every CHECK_SCAN_TICKS */
+static bool drive(uint32_t seed, bool grouped, check_stats_t* stats) {
+    button_workload_config_t config;
+    button_workload_t gen;
+    button_workload_edge_t edge;
+
+    if (!bank_open(grouped, 0)) {
+        printf("FAIL seed 0x%08lx: bank init\n", (unsigned long)seed);
+        return false;
+    }
+    ButtonWorkload_DefaultConfig(&config, seed, CHECK_BUTTONS, CHECK_DURATION);
+    config.mean_gap_ticks = 200u;
+    config.stages = check_stages;
+    config.stage_count = CHECK_STAGE_COUNT;
+    if (ButtonWorkload_Init(&gen, &config) != BUTTON_OK) {
+        printf("FAIL seed 0x%08lx: workload\n", (unsigned long)seed);
+        return false;
+    }
+
+    bool more = ButtonWorkload_Next(&gen, &edge);
+    uint32_t t = 0;
+    while (t < CHECK_DURATION) {
+        while (more && edge.tick <= t) {
+            levels[edge.index] = edge.pressed;
+            more = ButtonWorkload_Next(&gen, &edge);
+        }
+        if (!sweep_both(seed, t, stats)) return false;
+        toggle_controls(stats);
+
+        uint32_t next = 0;
+        if (!grouped) {
+            t += CHECK_SCAN_TICKS;
+        } else if (!ref_paused && (check_rand() & 1u) && Button_BankNextDue(&bank, &next) == BUTTON_OK &&
+                   (int32_t)(next - t) > 0) {
+            t = next;
+            stats->next_due++;
+        } else {
+            t += 1u + check_rand() % CHECK_MAX_GAP;
+        }
+    }
+    return true;
+}
+
+/* Tick of the first sweep of the held part at or after @p tick */
+static uint32_t first_sweep_after(uint32_t tick) {
+    if ((int32_t)(tick - CHECK_HELD_START) <= 0) return CHECK_HELD_START;
+    return CHECK_HELD_START + (tick - CHECK_HELD_START + CHECK_SCAN_TICKS - 1u) / CHECK_SCAN_TICKS * CHECK_SCAN_TICKS;
+}
+
+static bool held_at_init(uint32_t seed, uint32_t backdate, check_stats_t* stats) {
+    const button_init_config_t config = { .detect_held = true, .held_backdate_ticks = backdate };
+    uint32_t release[CHECK_BUTTONS];
+    button_event_mask_t seen[CHECK_BUTTONS];
+    uint32_t long_at = first_sweep_after(CHECK_HELD_START - backdate + BUTTON_LONG_PRESS_TICKS);
+    uint32_t end = CHECK_HELD_START + 4u * BUTTON_LONG_PRESS_TICKS;
+
+    if (!bank_open(false, CHECK_HELD_START)) {
+        printf("FAIL seed 0x%08lx: bank init\n", (unsigned long)seed);
+        return false;
+    }
+    for (uint16_t i = 0; i < CHECK_BUTTONS; i++) {
+        levels[i] = (check_rand() % 2u) == 0;
+        release[i] = CHECK_HELD_START + 1u + check_rand() % (3u * BUTTON_LONG_PRESS_TICKS);
+        seen[i] = 0;
+        if (!ref_init(i, &config)) return false;
+    }
+    if (Button_BankDetectHeld(&bank, backdate) != BUTTON_OK) {
+        printf("FAIL seed 0x%08lx: held detection\n", (unsigned long)seed);
+        return false;
+    }
+
+    for (uint32_t t = CHECK_HELD_START; t < end; t += CHECK_SCAN_TICKS) {
+        for (uint16_t i = 0; i < CHECK_BUTTONS; i++) {
+            if (levels[i] && t >= release[i]) levels[i] = false;
+        }
+        if (!sweep_both(seed, t, stats)) return false;
+
+        /* Without dispatch the events of one button come in enum order, so POWER_ON_HELD is taken first */
+        for (uint32_t e = 0; e < ref_log.count && e < CHECK_MAX_EVENTS; e++) {
+            if (ref_log.event[e] == BUTTON_EVENT_POWER_ON_HELD) seen[ref_log.index[e]] |= BUTTON_EVENT_BIT(BUTTON_EVENT_POWER_ON_HELD);
+        }
+        for (uint32_t e = 0; e < ref_log.count && e < CHECK_MAX_EVENTS; e++) {
+            uint16_t i = ref_log.index[e];
+            button_event_t event = ref_log.event[e];
+            bool early = !(seen[i] & BUTTON_EVENT_BIT(BUTTON_EVENT_POWER_ON_HELD));
+            if (event == BUTTON_EVENT_PRESSED || early ||
+                (event == BUTTON_EVENT_POWER_ON_HELD && t != CHECK_HELD_START) ||
+                (event == BUTTON_EVENT_LONG_PRESSED && t != long_at)) {
+                printf("FAIL seed 0x%08lx: back-date %lu, button %u event %d at tick %lu (long press due at %lu)\n",
+                       (unsigned long)seed, (unsigned long)backdate, (unsigned)i, (int)event,
+                       (unsigned long)t, (unsigned long)long_at);
+                return false;
+            }
+            seen[i] |= BUTTON_EVENT_BIT(event);
+        }
+    }
+
+    for (uint16_t i = 0; i < CHECK_BUTTONS; i++) {
+        bool held = (seen[i] != 0);
+        bool long_pressed = (seen[i] & BUTTON_EVENT_BIT(BUTTON_EVENT_LONG_PRESSED)) != 0;
+        if (held && long_pressed != (release[i] > long_at)) {
+            printf("FAIL seed 0x%08lx: back-date %lu, button %u released at %lu, long press %s (due at %lu)\n",
+                   (unsigned long)seed, (unsigned long)backdate, (unsigned)i, (unsigned long)release[i],
+                   long_pressed ? "dispatched" : "missing", (unsigned long)long_at);
+            return false;
+        }
+        if (held) stats->held++;
+        if (held && long_at == CHECK_HELD_START) stats->held_long++;
+    }
+    return true;
+}
+
+static bool run_one(uint32_t seed) {
+    check_stats_t stats = { 0 };
+    check_stats_t grouped = { 0 };
+    check_stats_t held = { 0 };
+
+    rng_state = seed | 1u;
+    if (!drive(seed, false, &stats)) return false;
+    if (!drive(seed, true, &grouped)) return false;
+    /* A group of period 0 is due on every sweep, so NextDue never lies ahead */
+    bool every_sweep = (groups[0].period_ticks == 0);
+    if (!held_at_init(seed, check_rand() % BUTTON_LONG_PRESS_TICKS, &held)) return false;
+    if (!held_at_init(seed, BUTTON_LONG_PRESS_TICKS + check_rand() % BUTTON_LONG_PRESS_TICKS, &held)) return false;
+    if (stats.released == 0 || stats.paused_presses == 0 ||
+        (!every_sweep && grouped.next_due == 0) || held.held_long == 0 || held.held_long == held.held) {
+        printf("FAIL seed 0x%08lx: no restart released a press (%lu), no pause held one (%lu), "
+               "no grouped sweep was at next due (%lu), or no long press at init (%lu of %lu held)\n", (unsigned long)seed,
+               (unsigned long)stats.released, (unsigned long)stats.paused_presses, (unsigned long)grouped.next_due,
+               (unsigned long)held.held_long, (unsigned long)held.held);
+        return false;
+    }
+
+    printf("ok   seed 0x%08lx: %lu sweeps, %lu toggles (%lu released), %lu pauses (%lu over a press); "
+           "grouped %lu sweeps, %lu at next due, %lu idle; %lu held (%lu long at init)\n",
+           (unsigned long)seed, (unsigned long)stats.sweeps, (unsigned long)stats.toggles,
+           (unsigned long)stats.released, (unsigned long)stats.pauses,
+           (unsigned long)stats.paused_presses, (unsigned long)grouped.sweeps, (unsigned long)grouped.next_due,
+           (unsigned long)grouped.idle_sweeps, (unsigned long)held.held, (unsigned long)held.held_long);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    uint32_t runs = 4;
+    uint32_t seed = 0x1234567u;
+    bool all_ok = true;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            runs = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            printf("usage: %s [-n runs] [-s seed]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    for (uint32_t r = 0; r < runs && all_ok; r++) {
+        all_ok = run_one(seed + r * 0x9E3779B9u);
+    }
+    return all_ok ? 0 : 1;
+}
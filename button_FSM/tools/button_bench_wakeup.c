@@ -0,0 +1,413 @@
+/**
+ * @file    button_bench_wakeup.c
+ * @author  datngyB
+ * @brief   Wakeup and energy accounting benchmark: polling, tickless and edge-driven.
+ * @version 0.1.0
+ * @date    2026-10-18
+ * * @copyright Copyright (c) 2026
+ *
+ * Replays the same simulated press workload (1 tick = 1 ms) through three ways
+ * of driving the FSM and reports, per simulated hour:
+ *   - wakeups       : times the CPU leaves sleep (timer or GPIO interrupt)
+ *   - update calls  : calls to Button_Update
+ *   - events        : callbacks dispatched by the FSM
+ *
+ * Modes:
+ *   polling  : Button_Update on every scan tick.
+ *   tickless : sleep in IDLE until the GPIO edge that wakes the CPU from
+ *              stop; while the button is in DEBOUNCE, PRESSED or LONG_PRESSED
+ *              the scan tick runs, shortened to the next FSM deadline when
+ *              that comes first. Only the IDLE edge is an interrupt.
+ *   edge     : sleep in IDLE until a GPIO edge; afterwards wake only on FSM
+ *              deadlines and edges. Edges inside the debounce window wake the
+ *              CPU but do not need an update call.
+ *
+ * The modes see the same presses but sample them at different times, so
+ * their HOLD counts differ by a few per hour; PRESSED, LONG_PRESSED and
+ * RELEASED match. Edge mode samples at the exact ticks. Both scanned modes
+ * see a release up to one scan period late:
+ *   - polling also enters LONG_PRESSED up to a scan period late, and HOLD
+ *     repeats from that entry, so a HOLD due just before the release can
+ *     fall after the sample that sees the release and is lost;
+ *   - tickless enters LONG_PRESSED on time, so a HOLD due between the
+ *     release and the next scan tick is still reported.
+ *
+ * Each mode also reports the wall-clock time of an update call, measured
+ * around the calls only, less the cost of reading the clock. With --perf,
+ * each mode is replayed a second time to count hardware counters
+ * (button_perf.h) per update call: cycles, instructions, branch misses and
+ * cache misses. They are enabled around the update calls only, so the trace
+ * stepping is left out but the ioctl stubs are in; compare them between
+ * builds of the FSM rather than as absolute costs.
+ *
+ * The workload comes from button_workload.h, with this benchmark's press
+ * classes: the trace is reproducible from the seed and the same models drive
+ * the differential oracle.
+ *
+ * Usage: button_bench_wakeup [--perf] [hours] [seed]
+ * Build: cc -O2 -Iinclude -Itools button_static.c tools/button_bench_wakeup.c tools/button_perf.c tools/button_workload.c -lm
+ */
+
+#include    <stdbool.h>
+#include    <stdint.h>
+#include    <stdio.h>
+#include    <stdlib.h>
+#include    <string.h>
+#include    <time.h>
+#include    "button_static.h"
+#include    "button_perf.h"
+#include    "button_workload.h"
+
+#define BENCH_TICKS_PER_HOUR        3600000u
+#define BENCH_POLL_PERIOD_TICKS     10u     /* Scan period of the polling mode */
+#define BENCH_MEAN_IDLE_TICKS       20000u  /* Mean gap between presses (Poisson arrivals) */
+#define BENCH_MAX_EDGES             (1u << 20)
+#define BENCH_CLOCK_SAMPLES         1000u   /* Back-to-back clock reads to find their cost */
+
+typedef enum {
+    BENCH_MODE_POLLING = 0,
+    BENCH_MODE_TICKLESS,
+    BENCH_MODE_EDGE,
+    BENCH_MODE_MAX
+} bench_mode_t;
+
+/* One raw pin transition of the replayed trace */
+typedef struct {
+    uint32_t tick;
+    bool level;             /* Electrical level after the edge (active low) */
+} bench_edge_t;
+
+typedef struct {
+    uint64_t wakeups;
+    uint64_t update_calls;
+    uint64_t events;
+    uint64_t update_ns;             /* Time spent in update calls, timed pass only */
+    button_perf_sample_t counters;  /* Valid entries only with --perf */
+} bench_result_t;
+
+static const char *const mode_names[BENCH_MODE_MAX] = { "polling", "tickless", "edge" };
+
+static const button_stage_config_t bench_stages[] = {
+    { BUTTON_SUPER_LONG_PRESS_TICKS, BUTTON_EVENT_SUPER_LONG_PRESSED, 0 },
+};
+
+/*
+ * Typical panel usage: mostly short taps, some long presses (most of them
+ * held into HOLD, which repeats from one long-press period after the long
+ * press) and a few presses that reach the super-long stage. Stage thresholds
+ * count from the long-press entry, so that class is anchored on the stage.
+ */
+static const button_workload_press_t bench_presses[] = {
+    { 75, BUTTON_WORKLOAD_ANCHOR_NONE,       80,  400 },
+    { 20, BUTTON_WORKLOAD_ANCHOR_LONG_PRESS, 100, 2500 },
+    {  5, BUTTON_WORKLOAD_ANCHOR_STAGE,      100, 3000 },
+};
+
+/* Simulation state shared with the HAL stubs */
+static bench_edge_t *trace;
+static uint32_t trace_len;
+static uint32_t trace_pos;
+static uint32_t sim_tick;
+static bool sim_level;
+static uint64_t sim_events;
+static uint64_t clock_cost_ns;
+
+static void trace_push(uint32_t tick, bool level);
+static bool generate_trace(uint32_t duration, uint32_t seed);
+static void sim_advance(uint32_t tick);
+static bool sim_read_pin(uint32_t pin_mask);
+static uint32_t sim_get_tick(void);
+#if BUTTON_FEATURE_DISPATCH
+static void sim_callback(button_event_t event, void* context);
+#endif
+static void bench_update(button_t* button);
+static uint64_t clock_ns(void);
+static uint64_t measure_clock_cost(void);
+static void measured_update(button_t* button, button_perf_t* perf, bench_result_t* result);
+static uint32_t next_deadline(const button_t* button, uint32_t now);
+static uint32_t next_wake(bench_mode_t mode, const button_t* button, uint32_t now, bool* by_edge);
+static bench_result_t run_mode(bench_mode_t mode, uint32_t duration, button_perf_t* perf);
+static void print_counters(const bench_result_t* r);
+
+static void trace_push(uint32_t tick, bool level) {
+    if (trace_len >= BENCH_MAX_EDGES) return;
+    if (trace_len > 0 && trace[trace_len - 1].level == level) return;
+    trace[trace_len].tick = tick;
+    trace[trace_len].level = level;
+    trace_len++;
+}
+
+/* Contact bounce of 1..3 ms per glitch, and a few stray spikes shorter than the debounce */
+static bool generate_trace(uint32_t duration, uint32_t seed) {
+    button_workload_config_t config;
+    button_workload_t gen;
+    button_workload_edge_t edge;
+
+    ButtonWorkload_DefaultConfig(&config, seed, 1, duration);
+    config.mean_gap_ticks = BENCH_MEAN_IDLE_TICKS;
+    config.presses = bench_presses;
+    config.press_count = (uint8_t)(sizeof(bench_presses) / sizeof(bench_presses[0]));
+    config.stages = bench_stages;
+    config.stage_count = (uint8_t)(sizeof(bench_stages) / sizeof(bench_stages[0]));
+    if (ButtonWorkload_Init(&gen, &config) != BUTTON_OK) return false;
+
+    trace_len = 0;
+    trace_push(0, true);    /* Released, active low */
+    while (ButtonWorkload_Next(&gen, &edge)) {
+        trace_push(edge.tick, !edge.pressed);
+    }
+    return true;
+}
+
+static void sim_advance(uint32_t tick) {
+    sim_tick = tick;
+    while (trace_pos < trace_len && trace[trace_pos].tick <= tick) {
+        sim_level = trace[trace_pos].level;
+        trace_pos++;
+    }
+}
+
+static bool sim_read_pin(uint32_t pin_mask) {
+    (void)pin_mask;
+    return sim_level;
+}
+
+static uint32_t sim_get_tick(void) {
+    return sim_tick;
+}
+
+#if BUTTON_FEATURE_DISPATCH
+static void sim_callback(button_event_t event, void* context) {
+    (void)event;
+    (void)context;
+    sim_events++;
+}
+#endif
+
+/* Without handlers the events of an update are counted from its mask */
+static void bench_update(button_t* button) {
+#if BUTTON_FEATURE_DISPATCH
+    Button_Update(button);
+#else
+    button_event_mask_t events;
+    Button_UpdateEx(button, &events);
+    sim_events += (uint64_t)__builtin_popcount((unsigned)events);
+#endif
+}
+
+static uint64_t clock_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/* Cheapest of a run of empty measurements: what a timed update pays for the clock itself */
+static uint64_t measure_clock_cost(void) {
+    uint64_t best = UINT64_MAX;
+    for (uint32_t i = 0; i < BENCH_CLOCK_SAMPLES; i++) {
+        uint64_t start = clock_ns();
+        uint64_t elapsed = clock_ns() - start;
+        if (elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+/* With @p perf the counters run around the call; otherwise the call is timed */
+static void measured_update(button_t* button, button_perf_t* perf, bench_result_t* result) {
+    result->update_calls++;
+    if (perf) {
+        ButtonPerf_Resume(perf);
+        bench_update(button);
+        ButtonPerf_Pause(perf);
+        return;
+    }
+    uint64_t start = clock_ns();
+    bench_update(button);
+    uint64_t elapsed = clock_ns() - start;
+    result->update_ns += (elapsed > clock_cost_ns) ? elapsed - clock_cost_ns : 0u;
+}
+
+/*
+ * Earliest tick at which the FSM can change state without a new edge. In
+ * STATE_LONG_PRESSED, press_start_tick is the long-press entry: stage and
+ * super-long thresholds count from it, and HOLD starts one long-press period
+ * after it, as in handle_state_long.
+ */
+static uint32_t next_deadline(const button_t* button, uint32_t now) {
+    uint32_t deadline = UINT32_MAX;
+
+    switch (button->last_state) {
+        case STATE_DEBOUNCE:
+            deadline = button->last_change_tick + BUTTON_DEBOUNCE_TICKS;
+            break;
+        case STATE_PRESSED:
+            deadline = button->last_change_tick + BUTTON_LONG_PRESS_TICKS;
+            break;
+        case STATE_LONG_PRESSED: {
+#if BUTTON_FEATURE_STAGES && BUTTON_FEATURE_HOLD
+            uint32_t hold_interval = button->hold_interval;
+#elif BUTTON_FEATURE_HOLD
+            uint32_t hold_interval = BUTTON_HOLD_TICKS;
+#else
+            uint32_t hold_interval = BUTTON_HOLD_OFF;
+#endif
+            if (hold_interval != BUTTON_HOLD_OFF) {
+                uint32_t hold = button->last_hold_tick + hold_interval;
+                uint32_t hold_start = button->press_start_tick + BUTTON_LONG_PRESS_TICKS;
+                if (hold < hold_start) hold = hold_start;
+                if (hold < deadline) deadline = hold;
+            }
+#if BUTTON_FEATURE_SUPER_LONG
+            if (!button->is_long_pressed_triggered && button->press_start_tick + BUTTON_SUPER_LONG_PRESS_TICKS < deadline) {
+                deadline = button->press_start_tick + BUTTON_SUPER_LONG_PRESS_TICKS;
+            }
+#endif
+#if BUTTON_FEATURE_STAGES
+            for (uint8_t i = 0; i < button->stages.count; i++) {
+                uint32_t at = button->press_start_tick + button->stages.configs[i].threshold;
+                if (!button->stages.latches[i] && at < deadline) deadline = at;
+            }
+#endif
+            break;
+        }
+        case STATE_IDLE:
+        default:
+            break;
+    }
+    return (deadline <= now) ? now + 1u : deadline;
+}
+
+/*
+ * Next wakeup of the sleeping modes. Edge mode takes every edge and deadline.
+ * Tickless only arms the edge interrupt in IDLE; if the pin is already
+ * pressed when it gets there, the edge is gone and the scan tick goes on.
+ */
+static uint32_t next_wake(bench_mode_t mode, const button_t* button, uint32_t now, bool* by_edge) {
+    bool edge_armed = (mode == BENCH_MODE_EDGE) || button->last_state == STATE_IDLE;
+    uint32_t wake = next_deadline(button, now);
+
+    if (mode == BENCH_MODE_TICKLESS && (button->last_state != STATE_IDLE || !sim_level)) {
+        if (now + BENCH_POLL_PERIOD_TICKS < wake) wake = now + BENCH_POLL_PERIOD_TICKS;
+    }
+    *by_edge = false;
+    if (edge_armed && trace_pos < trace_len && trace[trace_pos].tick <= wake) {
+        wake = trace[trace_pos].tick;
+        *by_edge = true;
+    }
+    return wake;
+}
+
+static bench_result_t run_mode(bench_mode_t mode, uint32_t duration, button_perf_t* perf) {
+    bench_result_t result;
+    memset(&result, 0, sizeof(result));
+    button_t button;
+    bool latches[sizeof(bench_stages) / sizeof(bench_stages[0])] = { false };
+
+    trace_pos = 0;
+    sim_events = 0;
+    sim_advance(0);
+
+    Button_Init(&button, 0, BUTTON_ACTIVE_LOW, sim_read_pin, sim_get_tick);
+#if BUTTON_FEATURE_STAGES
+    Button_ConfigStages(&button, bench_stages, latches, (uint8_t)(sizeof(bench_stages) / sizeof(bench_stages[0])));
+#else
+    (void)latches;
+#endif
+#if BUTTON_FEATURE_DISPATCH
+    Button_RegisterHandler(&button, sim_callback, NULL);
+#endif
+
+    if (perf) ButtonPerf_Reset(perf);
+    if (mode == BENCH_MODE_POLLING) {
+        for (uint32_t t = BENCH_POLL_PERIOD_TICKS; t < duration; t += BENCH_POLL_PERIOD_TICKS) {
+            sim_advance(t);
+            result.wakeups++;
+            measured_update(&button, perf, &result);
+        }
+    } else {
+        uint32_t t = 0;
+        for (;;) {
+            bool by_edge;
+            uint32_t wake = next_wake(mode, &button, t, &by_edge);
+            if (wake >= duration) break;
+
+            t = wake;
+            sim_advance(t);
+            result.wakeups++;
+            /* The FSM ignores the pin until the debounce deadline, so an edge there is only a wakeup */
+            if (by_edge && button.last_state == STATE_DEBOUNCE) continue;
+            measured_update(&button, perf, &result);
+        }
+    }
+
+    if (perf) ButtonPerf_Stop(perf, &result.counters);
+
+    result.events = sim_events;
+    Button_Deinit(&button);
+    return result;
+}
+
+static void print_counters(const bench_result_t* r) {
+    printf("%-10s", "");
+    for (int c = 0; c < BUTTON_PERF_MAX; c++) {
+        if (!r->counters.valid[c]) {
+            printf(" %s n/a", ButtonPerf_Name((button_perf_counter_t)c));
+        } else {
+            printf(" %s %.1f/upd", ButtonPerf_Name((button_perf_counter_t)c),
+                   (double)r->counters.value[c] / (double)(r->update_calls ? r->update_calls : 1u));
+        }
+    }
+    if (r->counters.valid[BUTTON_PERF_CYCLES] && r->counters.valid[BUTTON_PERF_INSTRUCTIONS] && r->counters.value[BUTTON_PERF_CYCLES]) {
+        printf(" IPC %.2f", (double)r->counters.value[BUTTON_PERF_INSTRUCTIONS] / (double)r->counters.value[BUTTON_PERF_CYCLES]);
+    }
+    printf("\n");
+}
+
+int main(int argc, char** argv) {
+    button_perf_t perf;
+    bool use_perf = false;
+
+    if (argc > 1 && strcmp(argv[1], "--perf") == 0) {
+        use_perf = true;
+        argv++;
+        argc--;
+    }
+    uint32_t hours = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 1u;
+    uint32_t seed = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : 0x2545F491u;
+    if (hours == 0 || hours > 1000) hours = 1;
+
+    trace = malloc(sizeof(*trace) * BENCH_MAX_EDGES);
+    if (!trace) return 1;
+
+    if (use_perf && !ButtonPerf_Open(&perf)) {
+        printf("perf: no hardware counters available (perf_event_paranoid or no PMU), timings only\n");
+        ButtonPerf_Close(&perf);
+        use_perf = false;
+    }
+
+    uint32_t duration = BENCH_TICKS_PER_HOUR * hours;
+    if (!generate_trace(duration, seed)) return 1;
+    clock_cost_ns = measure_clock_cost();
+
+    printf("workload: %u h simulated, %u edges, scan period %u ticks\n",
+           (unsigned)hours, (unsigned)trace_len, (unsigned)BENCH_POLL_PERIOD_TICKS);
+    printf("%-10s %14s %14s %14s %12s %10s\n", "mode", "wakeups/h", "updates/h", "events/h", "wakeups/s", "ns/update");
+
+    for (int m = 0; m < BENCH_MODE_MAX; m++) {
+        bench_result_t r = run_mode((bench_mode_t)m, duration, NULL);
+        printf("%-10s %14llu %14llu %14llu %12.3f %10.1f\n", mode_names[m],
+               (unsigned long long)(r.wakeups / hours),
+               (unsigned long long)(r.update_calls / hours),
+               (unsigned long long)(r.events / hours),
+               (double)r.wakeups / ((double)duration / 1000.0),
+               (double)r.update_ns / (double)(r.update_calls ? r.update_calls : 1u));
+        if (use_perf) {
+            bench_result_t counted = run_mode((bench_mode_t)m, duration, &perf);
+            print_counters(&counted);
+        }
+    }
+
+    if (use_perf) ButtonPerf_Close(&perf);
+    free(trace);
+    return 0;
+}
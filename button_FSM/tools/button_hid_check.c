@@ -0,0 +1,266 @@
+/**
+ * @file    button_hid_check.c
+ * @author  datngyB
+ * @brief   button_hid against a reference model that rebuilds both reports from scratch.
+ * @version 0.1.0
+ * @date    2026-10-18
+ * * @copyright Copyright (c) 2026
+ *
+ * Each run maps a random panel (plain keys, modifiers, non-keys) and applies
+ * random key changes, alternately through ButtonHid_SetKey and as bank events
+ * through ButtonHid_OnEvent, including repeated presses and releases and
+ * events that must be ignored. The press bias keeps the key count around the
+ * six boot slots, so rollover is entered and left often. The host switches
+ * protocol at random and reports are taken at random points.
+ *
+ * The model keeps only the keys down and a rank per key, and after every
+ * change rebuilds both reports:
+ *   - boot: modifiers, then the keys down ordered by rank, or all slots at
+ *     ErrorRollOver above six keys. A key pressed outside rollover ranks by
+ *     press order; keys down when rollover is left rank by usage, ahead of
+ *     anything pressed later;
+ *   - NKRO: modifiers, then one bit per key down.
+ * A report must be handed out exactly when its protocol switched or its
+ * content changed since the last one taken, and must match the model.
+ *
+ * Usage: button_hid_check [-n runs] [-s seed]
+ * Build: cc -O2 -Iinclude button_hid.c tools/button_hid_check.c
+ * Exit status is non-zero on the first mismatch.
+ */
+
+#include    <stdbool.h>
+#include    <stdint.h>
+#include    <stdio.h>
+#include    <stdlib.h>
+#include    <string.h>
+#include    "button_hid.h"
+
+#define CHECK_MAX_BUTTONS           48u
+#define CHECK_CHANGES               20000u      /* Per run: the default 10 runs make 200k */
+
+/* Reference model */
+typedef struct {
+    bool down[256];
+    uint32_t rank[256];             /**< Boot slot order of a key down */
+    uint32_t next_rank;             /**< Above every usage, so later presses list after a refill */
+    uint8_t boot[BUTTON_HID_BOOT_REPORT_SIZE];
+    uint8_t nkro[BUTTON_HID_NKRO_REPORT_SIZE];
+    bool boot_dirty;
+    bool nkro_dirty;
+    uint8_t sent_protocol;
+} check_model_t;
+
+static uint32_t rng_state;
+
+static uint32_t check_rand(void);
+static uint8_t model_keys(const check_model_t* model);
+static void model_build(const check_model_t* model, uint8_t* boot, uint8_t* nkro);
+static void model_set(check_model_t* model, uint8_t usage, bool pressed);
+static bool check_init_rejects(void);
+static bool run_one(uint32_t seed);
+
+
+static uint32_t check_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static uint8_t model_keys(const check_model_t* model) {
+    uint8_t n = 0;
+    for (unsigned int u = 0; u < BUTTON_HID_MODIFIER_FIRST; u++) {
+        if (model->down[u]) n++;
+    }
+    return n;
+}
+
+static void model_build(const check_model_t* model, uint8_t* boot, uint8_t* nkro) {
+    uint8_t mods = 0;
+    for (unsigned int u = BUTTON_HID_MODIFIER_FIRST; u <= BUTTON_HID_MODIFIER_LAST; u++) {
+        if (model->down[u]) mods |= (uint8_t)(1u << (u - BUTTON_HID_MODIFIER_FIRST));
+    }
+
+    memset(boot, 0, BUTTON_HID_BOOT_REPORT_SIZE);
+    memset(nkro, 0, BUTTON_HID_NKRO_REPORT_SIZE);
+    boot[0] = mods;
+    nkro[0] = mods;
+    for (unsigned int u = 0; u < BUTTON_HID_MODIFIER_FIRST; u++) {
+        if (model->down[u]) nkro[2u + u / 8u] |= (uint8_t)(1u << (u % 8u));
+    }
+
+    if (model_keys(model) > BUTTON_HID_BOOT_KEYS) {
+        memset(&boot[2], BUTTON_HID_ERROR_ROLLOVER, BUTTON_HID_BOOT_KEYS);
+        return;
+    }
+    /* Selection by rank: at most six keys down */
+    uint32_t last = 0;
+    bool first = true;
+    for (unsigned int s = 0; s < BUTTON_HID_BOOT_KEYS; s++) {
+        unsigned int best = 256u;
+        for (unsigned int u = 0; u < BUTTON_HID_MODIFIER_FIRST; u++) {
+            if (!model->down[u] || (!first && model->rank[u] <= last)) continue;
+            if (best == 256u || model->rank[u] < model->rank[best]) best = u;
+        }
+        if (best == 256u) break;
+        boot[2u + s] = (uint8_t)best;
+        last = model->rank[best];
+        first = false;
+    }
+}
+
+static void model_set(check_model_t* model, uint8_t usage, bool pressed) {
+    uint8_t boot[BUTTON_HID_BOOT_REPORT_SIZE];
+    uint8_t nkro[BUTTON_HID_NKRO_REPORT_SIZE];
+    if (usage == BUTTON_HID_USAGE_NONE || model->down[usage] == pressed) return;
+
+    bool rolled = model_keys(model) > BUTTON_HID_BOOT_KEYS;
+    model->down[usage] = pressed;
+    if (pressed) {
+        model->rank[usage] = model->next_rank++;
+    } else if (rolled && model_keys(model) == BUTTON_HID_BOOT_KEYS) {
+        for (unsigned int u = 0; u < BUTTON_HID_MODIFIER_FIRST; u++) model->rank[u] = u;
+    }
+
+    model_build(model, boot, nkro);
+    if (memcmp(boot, model->boot, sizeof(boot)) != 0) model->boot_dirty = true;
+    if (memcmp(nkro, model->nkro, sizeof(nkro)) != 0) model->nkro_dirty = true;
+    memcpy(model->boot, boot, sizeof(boot));
+    memcpy(model->nkro, nkro, sizeof(nkro));
+}
+
+/* Duplicate usages, error codes and reserved usages are refused */
+static bool check_init_rejects(void) {
+    static const uint8_t duplicate[] = { 0x04u, 0x05u, 0x04u };
+    static const uint8_t error_code[] = { 0x04u, BUTTON_HID_ERROR_ROLLOVER };
+    static const uint8_t reserved[] = { 0xE8u };
+    static const uint8_t valid[] = { BUTTON_HID_USAGE_NONE, 0x04u, 0xDFu, 0xE0u, 0xE7u, BUTTON_HID_USAGE_NONE };
+    button_hid_t hid;
+
+    return ButtonHid_Init(&hid, duplicate, 3) != BUTTON_OK &&
+           ButtonHid_Init(&hid, error_code, 2) != BUTTON_OK &&
+           ButtonHid_Init(&hid, reserved, 1) != BUTTON_OK &&
+           ButtonHid_Init(&hid, valid, 6) == BUTTON_OK &&
+           ButtonHid_SetProtocol(&hid, (button_hid_protocol_t)2) != BUTTON_OK;
+}
+
+static bool run_one(uint32_t seed) {
+    uint8_t usages[CHECK_MAX_BUTTONS];
+    bool taken[256] = { false };
+    button_hid_t hid;
+    static check_model_t model;
+    uint8_t report[BUTTON_HID_NKRO_REPORT_SIZE];
+    uint32_t reports = 0;
+    uint32_t rollovers = 0;
+    uint32_t switches = 0;
+
+    rng_state = seed | 1u;
+    uint16_t count = (uint16_t)(8u + check_rand() % (CHECK_MAX_BUTTONS - 7u));
+    for (uint16_t i = 0; i < count; i++) {
+        uint32_t kind = check_rand() % 8u;
+        uint8_t u = BUTTON_HID_USAGE_NONE;
+        if (kind == 1) {
+            u = (uint8_t)(BUTTON_HID_MODIFIER_FIRST + check_rand() % 8u);
+            if (taken[u]) u = BUTTON_HID_USAGE_NONE;
+        } else if (kind != 0) {
+            do {
+                u = (uint8_t)(0x04u + check_rand() % (BUTTON_HID_MODIFIER_FIRST - 0x04u));
+            } while (taken[u]);
+        }
+        taken[u] = true;
+        usages[i] = u;
+    }
+
+    memset(&model, 0, sizeof(model));
+    model.next_rank = 256u;
+    model.boot_dirty = true;
+    model.nkro_dirty = true;
+    if (ButtonHid_Init(&hid, usages, count) != BUTTON_OK) {
+        printf("FAIL seed 0x%08lx: init\n", (unsigned long)seed);
+        return false;
+    }
+
+    for (uint32_t c = 0; c < CHECK_CHANGES; c++) {
+        uint16_t index = (uint16_t)(check_rand() % count);
+        uint8_t u = usages[index];
+        /* Around six keys down, so rollover comes and goes */
+        bool pressed = (check_rand() % 100u) < (model_keys(&model) < BUTTON_HID_BOOT_KEYS ? 65u : 40u);
+        bool was_rolled = model_keys(&model) > BUTTON_HID_BOOT_KEYS;
+
+        switch (check_rand() % 4u) {
+            case 0:
+                ButtonHid_SetKey(&hid, index, pressed);
+                model_set(&model, u, pressed);
+                break;
+            case 1:
+                ButtonHid_OnEvent(index, pressed ? BUTTON_EVENT_PRESSED : BUTTON_EVENT_RELEASED, &hid);
+                model_set(&model, u, pressed);
+                break;
+            case 2:
+                /* Only the events that start and end a press touch the reports */
+                ButtonHid_OnEvent(index, (check_rand() & 1u) ? BUTTON_EVENT_LONG_PRESSED : BUTTON_EVENT_HOLD, &hid);
+                break;
+            default:
+                ButtonHid_OnEvent(index, pressed ? BUTTON_EVENT_POWER_ON_HELD : BUTTON_EVENT_RELEASED, &hid);
+                model_set(&model, u, pressed);
+                break;
+        }
+        if (!was_rolled && model_keys(&model) > BUTTON_HID_BOOT_KEYS) rollovers++;
+
+        if (check_rand() % 50u == 0) {
+            ButtonHid_SetProtocol(&hid, (check_rand() & 1u) ? BUTTON_HID_PROTOCOL_NKRO : BUTTON_HID_PROTOCOL_BOOT);
+            switches++;
+        }
+        if (check_rand() % 3u != 0) continue;
+
+        uint8_t protocol = (uint8_t)atomic_load(&hid.protocol);
+        bool nkro = protocol == BUTTON_HID_PROTOCOL_NKRO;
+        bool *dirty = nkro ? &model.nkro_dirty : &model.boot_dirty;
+        const uint8_t *expected = nkro ? model.nkro : model.boot;
+        size_t size = nkro ? BUTTON_HID_NKRO_REPORT_SIZE : BUTTON_HID_BOOT_REPORT_SIZE;
+        bool due = *dirty || protocol != model.sent_protocol;
+        size_t len = 0;
+
+        if (ButtonHid_TakeReport(&hid, report, sizeof(report), &len) != BUTTON_OK ||
+            len != (due ? size : 0u) || (len && memcmp(report, expected, size) != 0)) {
+            printf("FAIL seed 0x%08lx: change %lu, %s report %s (%lu keys down)\n", (unsigned long)seed, (unsigned long)c,
+                   nkro ? "NKRO" : "boot", (len == 0) ? "missing" : (due ? "differs" : "repeated"),
+                   (unsigned long)model_keys(&model));
+            return false;
+        }
+        if (len) reports++;
+        *dirty = false;
+        model.sent_protocol = protocol;
+    }
+
+    printf("ok   seed 0x%08lx %2u buttons: %lu changes, %lu reports, %lu rollovers, %lu protocol switches\n",
+           (unsigned long)seed, (unsigned)count, (unsigned long)CHECK_CHANGES, (unsigned long)reports,
+           (unsigned long)rollovers, (unsigned long)switches);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    uint32_t runs = 10;
+    uint32_t seed = 0x1234567u;
+    bool all_ok = true;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            runs = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            printf("usage: %s [-n runs] [-s seed]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (!check_init_rejects()) {
+        printf("FAIL init accepted a bad usage table or protocol\n");
+        return 1;
+    }
+    for (uint32_t r = 0; r < runs && all_ok; r++) {
+        all_ok = run_one(seed + r * 0x9E3779B9u);
+    }
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,227 @@
+/**
+ * @file    button_input_check.c
+ * @author  datngyB
+ * @brief   Levels read by button_input from pipes and a regular file, on both backends.
+ * @version 0.1.0
+ * @date    2026-10-18
+ * * @copyright Copyright (c) 2026
+ *
+ * Each run opens a reader over CHECK_PIPES pipes, some already nonblocking,
+ * and one regular file that is appended to; runs alternate between asking
+ * for io_uring and using epoll. At every step random inputs get a burst of
+ * level bytes ("1", "0\n", "10 1"...) and the reader is polled until it
+ * reports, for every input, the last level written; the number of changes it
+ * reports must match. Near the end one pipe hangs up and must keep its last
+ * level.
+ *
+ * After ButtonInput_Close:
+ *   - every descriptor has the file status flags it had before Open;
+ *   - no read is left queued: every completion was reaped, and a byte
+ *     written into each open pipe is still there for a plain read.
+ *
+ * Usage: button_input_check [-n runs] [-s seed]
+ * Build: cc -O2 -Iinclude linux/button_input.c tools/button_input_check.c
+ * Exit status is non-zero on the first mismatch. Runs that ask for io_uring
+ * where the kernel refuses a ring say so and are checked on epoll.
+ */
+
+#define     _GNU_SOURCE
+#include    <stdbool.h>
+#include    <stdint.h>
+#include    <stdio.h>
+#include    <stdlib.h>
+#include    <string.h>
+#include    <fcntl.h>
+#include    <poll.h>
+#include    <unistd.h>
+#include    "button_input.h"
+
+#define CHECK_PIPES                 8u
+#define CHECK_INPUTS                (CHECK_PIPES + 1u)  /* Last input is the regular file */
+#define CHECK_STEPS                 2000u
+#define CHECK_POLL_LIMIT            100u                /* Polls before a written level counts as lost */
+#define CHECK_BURST_MAX             6u
+
+static uint32_t rng_state;
+
+static uint32_t check_rand(void);
+static bool write_burst(int fd, bool* level);
+static bool wait_levels(button_input_t* input, const bool* expected, uint32_t* changes);
+static bool pipe_kept_data(int fd);
+static bool run_one(uint32_t seed);
+
+
+static uint32_t check_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+/* One write of level bytes with blanks in between; the last non-blank one is the new level */
+static bool write_burst(int fd, bool* level) {
+    char burst[CHECK_BURST_MAX * 2u];
+    size_t len = 0;
+    uint32_t n = 1u + check_rand() % CHECK_BURST_MAX;
+
+    for (uint32_t k = 0; k < n; k++) {
+        *level = (check_rand() & 1u) != 0;
+        burst[len++] = *level ? '1' : '0';
+        uint32_t blank = check_rand() % 4u;
+        if (blank == 1) burst[len++] = '\n';
+        else if (blank == 2) burst[len++] = ' ';
+    }
+    return write(fd, burst, len) == (ssize_t)len;
+}
+
+/* Polls until every level matches; @p changes accumulates what the reader reported */
+static bool wait_levels(button_input_t* input, const bool* expected, uint32_t* changes) {
+    for (uint32_t p = 0; p < CHECK_POLL_LIMIT; p++) {
+        uint16_t changed = 0;
+        if (ButtonInput_Poll(input, &changed) != BUTTON_OK) return false;
+        *changes += changed;
+
+        bool same = true;
+        for (uint16_t i = 0; same && i < CHECK_INPUTS; i++) {
+            same = ButtonInput_Level(input, i) == expected[i];
+        }
+        if (same) return true;
+        if (p > 0) usleep(100);
+    }
+    return false;
+}
+
+/* The byte written after Close is still in the pipe, so no cancelled read took it */
+static bool pipe_kept_data(int fd) {
+    struct pollfd pfd = { .fd = fd, .events = POLLIN };
+    char c;
+    if (poll(&pfd, 1, 1000) != 1) return false;
+    return read(fd, &c, 1) == 1 && c == 'x';
+}
+
+static bool run_one(uint32_t seed) {
+    int pipes[CHECK_PIPES][2];
+    int fds[CHECK_INPUTS];
+    int flags_before[CHECK_INPUTS];
+    bool expected[CHECK_INPUTS] = { false };
+    bool hung_up = false;
+    button_input_t input;
+    char path[] = "/tmp/button_input_check.XXXXXX";
+
+    rng_state = seed | 1u;
+    bool want_uring = (seed & 1u) == 0;
+    uint32_t hangup_at = CHECK_STEPS - 2u - check_rand() % (CHECK_STEPS / 4u);
+    uint16_t hangup_pipe = (uint16_t)(check_rand() % CHECK_PIPES);
+
+    for (uint16_t i = 0; i < CHECK_PIPES; i++) {
+        if (pipe2(pipes[i], O_CLOEXEC | ((check_rand() & 1u) ? O_NONBLOCK : 0)) != 0) {
+            printf("FAIL seed 0x%08lx: pipe\n", (unsigned long)seed);
+            return false;
+        }
+        fds[i] = pipes[i][0];
+    }
+    int file_writer = mkostemp(path, O_CLOEXEC | O_APPEND);
+    fds[CHECK_PIPES] = (file_writer >= 0) ? open(path, O_RDONLY | O_CLOEXEC) : -1;
+    if (file_writer >= 0) unlink(path);
+    for (uint16_t i = 0; i < CHECK_INPUTS; i++) {
+        flags_before[i] = (fds[i] >= 0) ? fcntl(fds[i], F_GETFL) : -1;
+    }
+
+    if (fds[CHECK_PIPES] < 0 || ButtonInput_Open(&input, fds, (uint16_t)CHECK_INPUTS, want_uring) != BUTTON_OK) {
+        printf("FAIL seed 0x%08lx: open\n", (unsigned long)seed);
+        return false;
+    }
+    if (want_uring && input.backend != BUTTON_INPUT_BACKEND_IO_URING) {
+        printf("note seed 0x%08lx: io_uring refused by the kernel, checked on epoll\n", (unsigned long)seed);
+    }
+    const char *backend = (input.backend == BUTTON_INPUT_BACKEND_IO_URING) ? "io_uring" : "epoll";
+
+    bool ok = true;
+    uint32_t changes = 0;
+    uint32_t expected_changes = 0;
+    for (uint32_t step = 0; step < CHECK_STEPS && ok; step++) {
+        if (step == hangup_at) {
+            close(pipes[hangup_pipe][1]);
+            pipes[hangup_pipe][1] = -1;
+            hung_up = true;
+        }
+        for (uint16_t i = 0; i < CHECK_INPUTS && ok; i++) {
+            if (check_rand() % 4u != 0) continue;
+            int fd = (i < CHECK_PIPES) ? pipes[i][1] : file_writer;
+            if (fd < 0) continue;
+            bool before = expected[i];
+            ok = write_burst(fd, &expected[i]);
+            if (expected[i] != before) expected_changes++;
+        }
+        if (!ok) {
+            printf("FAIL seed 0x%08lx: write at step %lu\n", (unsigned long)seed, (unsigned long)step);
+        } else if (!wait_levels(&input, expected, &changes)) {
+            printf("FAIL seed 0x%08lx %s: step %lu levels not reported\n", (unsigned long)seed, backend, (unsigned long)step);
+            ok = false;
+        } else if (changes != expected_changes) {
+            printf("FAIL seed 0x%08lx %s: step %lu reported %lu changes, expected %lu\n", (unsigned long)seed, backend,
+                   (unsigned long)step, (unsigned long)changes, (unsigned long)expected_changes);
+            ok = false;
+        }
+    }
+    if (ok && (!hung_up || !input.closed[hangup_pipe])) {
+        printf("FAIL seed 0x%08lx %s: pipe %u hangup not seen\n", (unsigned long)seed, backend, (unsigned)hangup_pipe);
+        ok = false;
+    }
+
+    ButtonInput_Close(&input);
+    for (uint16_t i = 0; ok && i < CHECK_INPUTS; i++) {
+        if (fcntl(fds[i], F_GETFL) != flags_before[i]) {
+            printf("FAIL seed 0x%08lx %s: input %u flags not restored\n", (unsigned long)seed, backend, (unsigned)i);
+            ok = false;
+        }
+    }
+    for (uint16_t i = 0; ok && i < CHECK_INPUTS; i++) {
+        if (input.in_flight[i]) {
+            printf("FAIL seed 0x%08lx %s: input %u read still in flight\n", (unsigned long)seed, backend, (unsigned)i);
+            ok = false;
+        }
+    }
+    for (uint16_t i = 0; ok && i < CHECK_PIPES; i++) {
+        if (pipes[i][1] < 0) continue;
+        if (write(pipes[i][1], "x", 1) != 1 || !pipe_kept_data(fds[i])) {
+            printf("FAIL seed 0x%08lx %s: pipe %u lost data to a read left queued\n", (unsigned long)seed, backend, (unsigned)i);
+            ok = false;
+        }
+    }
+
+    for (uint16_t i = 0; i < CHECK_PIPES; i++) {
+        close(pipes[i][0]);
+        if (pipes[i][1] >= 0) close(pipes[i][1]);
+    }
+    close(fds[CHECK_PIPES]);
+    close(file_writer);
+
+    if (ok) {
+        printf("ok   seed 0x%08lx %-8s: %lu steps, %lu level changes, pipe %u hung up at %lu\n", (unsigned long)seed, backend,
+               (unsigned long)CHECK_STEPS, (unsigned long)changes, (unsigned)hangup_pipe, (unsigned long)hangup_at);
+    }
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    uint32_t runs = 8;
+    uint32_t seed = 0x1234567u;
+    bool all_ok = true;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            runs = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            printf("usage: %s [-n runs] [-s seed]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    for (uint32_t r = 0; r < runs && all_ok; r++) {
+        all_ok = run_one(seed + r * 0x9E3779B9u);
+    }
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,319 @@
+/**
+ * @file    button_latency_check.c
+ * @author  datngyB
+ * @brief   Edge-to-event latency of a bank, and snapshots taken while it records.
+ * @version 0.1.0
+ * @date    2026-10-18
+ * * @copyright Copyright (c) 2026
+ *
+ * Each run checks three things:
+ *   - stale edges: a release whose bounce is marked after RELEASED was
+ *     dispatched, then a press much later. The press must be measured from
+ *     its own edge, not from the bounce (the recorded latency used to be the
+ *     whole idle gap);
+ *   - a panel workload (button_workload.h) with every raw edge marked from
+ *     the "interrupt" and the bank swept every CHECK_SCAN_TICKS. Every
+ *     recorded latency stays within the debounce, two scan periods and one
+ *     bounce burst, and with dispatch every PRESSED and RELEASED is recorded
+ *     once;
+ *   - a writer thread records a known sequence of latencies while the main
+ *     thread takes ButtonLatency_Snapshot copies; every copy must be a
+ *     prefix of that sequence (count, sum, max and buckets agree), and its
+ *     100th percentile must be its max. On a single CPU the threads rarely
+ *     overlap inside a Record, so a snapshot over a write left open (odd
+ *     sequence) must also fail.
+ *
+ * Usage: button_latency_check [-n runs] [-s seed]
+ * Build: cc -O2 -pthread -Iinclude -Itools button_static.c button_bank.c button_latency.c tools/button_latency_check.c tools/button_workload.c -lm
+ * Exit status is non-zero on the first mismatch.
+ */
+
+#include    <stdbool.h>
+#include    <stdint.h>
+#include    <stdio.h>
+#include    <stdlib.h>
+#include    <string.h>
+#include    <stdatomic.h>
+#include    <pthread.h>
+#include    <sched.h>
+#include    "button_bank.h"
+#include    "button_workload.h"
+
+#define CHECK_BUTTONS               8u
+#define CHECK_DURATION              600000u
+#define CHECK_SCAN_TICKS            5u
+#define CHECK_DEBOUNCE_TICKS        20u
+#define CHECK_LONG_PRESS_TICKS      500u
+#define CHECK_HOLD_TICKS            100u
+#define CHECK_IDLE_GAP              60000u  /* Between the bounced release and the next press of the stale-edge case */
+#define CHECK_RECORDS               2000000u
+#define CHECK_RECORD_PERIOD         64u     /* Record i measures i % CHECK_RECORD_PERIOD ticks */
+#define CHECK_YIELD_RECORDS         256u
+
+static const button_profile_t check_profile = { CHECK_DEBOUNCE_TICKS, CHECK_LONG_PRESS_TICKS, CHECK_HOLD_TICKS, NULL, 0 };
+
+static button_bank_entry_t entries[CHECK_BUTTONS];
+static button_bank_state_t states[CHECK_BUTTONS];
+static button_latency_t latency[CHECK_BUTTONS];
+static button_bank_t bank;
+static bool levels[CHECK_BUTTONS];
+static uint32_t sweep_tick;
+#if BUTTON_FEATURE_DISPATCH
+static uint32_t measured_events[CHECK_BUTTONS];
+#endif
+
+/* Snapshot part: one histogram recorded by the writer thread */
+static button_latency_t shared_latency;
+static atomic_bool writer_done;
+static uint32_t rng_state;
+
+static uint32_t check_rand(void);
+static bool check_read_pin(uint32_t gpio_num);
+static uint32_t check_get_tick(void);
+#if BUTTON_FEATURE_DISPATCH
+static void check_event(uint16_t index, button_event_t event, void* context);
+#endif
+static bool bank_open(void);
+static void sweep_at(uint32_t tick);
+static bool stale_edge_dropped(uint32_t seed);
+static bool workload_bounded(uint32_t seed, uint32_t* events);
+static bool snapshot_matches(const button_latency_snapshot_t* snap);
+static void* writer_main(void* arg);
+static bool snapshots_consistent(uint32_t seed, uint32_t* taken);
+static bool run_one(uint32_t seed);
+
+
+static uint32_t check_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static bool check_read_pin(uint32_t gpio_num) {
+    return levels[gpio_num];
+}
+
+static uint32_t check_get_tick(void) {
+    return sweep_tick;
+}
+
+#if BUTTON_FEATURE_DISPATCH
+static void check_event(uint16_t index, button_event_t event, void* context) {
+    (void)context;
+    if (event == BUTTON_EVENT_PRESSED || event == BUTTON_EVENT_RELEASED) measured_events[index]++;
+}
+#endif
+
+static bool bank_open(void) {
+    memset(entries, 0, sizeof(entries));
+    memset(levels, 0, sizeof(levels));
+    for (uint16_t i = 0; i < CHECK_BUTTONS; i++) {
+        entries[i].gpio_num = i;
+        entries[i].active_level = BUTTON_ACTIVE_HIGH;
+    }
+    sweep_tick = 0;
+    if (Button_BankInit(&bank, entries, states, CHECK_BUTTONS, &check_profile, 1, check_read_pin, check_get_tick) != BUTTON_OK) return false;
+    if (Button_BankConfigLatency(&bank, latency) != BUTTON_OK) return false;
+#if BUTTON_FEATURE_DISPATCH
+    memset(measured_events, 0, sizeof(measured_events));
+    Button_BankRegisterHandler(&bank, check_event, NULL);
+#endif
+    return true;
+}
+
+static void sweep_at(uint32_t tick) {
+    sweep_tick = tick;
+    Button_BankUpdate(&bank);
+}
+
+/* Press, release with bounce marked after the RELEASED sweep, then a press CHECK_IDLE_GAP later */
+static bool stale_edge_dropped(uint32_t seed) {
+    button_latency_snapshot_t snap;
+    uint32_t press = 100u + check_rand() % CHECK_SCAN_TICKS;
+    uint32_t release = press + 200u;
+    uint32_t again = release + CHECK_IDLE_GAP;
+    uint32_t t = 0;
+
+    if (!bank_open()) {
+        printf("FAIL seed 0x%08lx: bank init\n", (unsigned long)seed);
+        return false;
+    }
+    for (; t < press; t += CHECK_SCAN_TICKS) sweep_at(t);
+    levels[0] = true;
+    Button_BankMarkEdge(&bank, 0, press);
+    for (; t < release; t += CHECK_SCAN_TICKS) sweep_at(t);
+    levels[0] = false;
+    Button_BankMarkEdge(&bank, 0, release);
+    sweep_at(t);                        /* RELEASED */
+    t += CHECK_SCAN_TICKS;
+    /* Bounce edges between two sweeps that both sample the released level */
+    Button_BankMarkEdge(&bank, 0, t - 3u);
+    Button_BankMarkEdge(&bank, 0, t - 2u);
+    for (; t < again; t += CHECK_SCAN_TICKS) sweep_at(t);
+    levels[0] = true;
+    Button_BankMarkEdge(&bank, 0, again);
+    for (; t < again + CHECK_DEBOUNCE_TICKS + 2u * CHECK_SCAN_TICKS; t += CHECK_SCAN_TICKS) sweep_at(t);
+
+    uint32_t bound = CHECK_DEBOUNCE_TICKS + CHECK_SCAN_TICKS;
+    if (ButtonLatency_Snapshot(&latency[0], &snap) != BUTTON_OK || snap.count != 3u || snap.max_ticks > bound) {
+        printf("FAIL seed 0x%08lx: stale bounce edge, %lu events measured, max %lu ticks (bound %lu)\n", (unsigned long)seed,
+               (unsigned long)snap.count, (unsigned long)snap.max_ticks, (unsigned long)bound);
+        return false;
+    }
+    return true;
+}
+
+static bool workload_bounded(uint32_t seed, uint32_t* events) {
+    button_workload_config_t config;
+    button_workload_t gen;
+    button_workload_edge_t edge;
+
+    if (!bank_open()) {
+        printf("FAIL seed 0x%08lx: bank init\n", (unsigned long)seed);
+        return false;
+    }
+    ButtonWorkload_DefaultConfig(&config, seed, CHECK_BUTTONS, CHECK_DURATION);
+    config.mean_gap_ticks = 2000u;
+    config.debounce_ticks = CHECK_DEBOUNCE_TICKS;
+    config.long_press_ticks = CHECK_LONG_PRESS_TICKS;
+    if (ButtonWorkload_Init(&gen, &config) != BUTTON_OK) {
+        printf("FAIL seed 0x%08lx: workload\n", (unsigned long)seed);
+        return false;
+    }
+
+    /* Edges are marked at their own tick; sweeps come every CHECK_SCAN_TICKS */
+    bool more = ButtonWorkload_Next(&gen, &edge);
+    for (uint32_t t = 0; t < CHECK_DURATION; t++) {
+        while (more && edge.tick == t) {
+            levels[edge.index] = edge.pressed;
+            Button_BankMarkEdge(&bank, edge.index, t);
+            more = ButtonWorkload_Next(&gen, &edge);
+        }
+        if (t % CHECK_SCAN_TICKS == 0) sweep_at(t);
+    }
+
+    uint32_t bound = CHECK_DEBOUNCE_TICKS + 2u * CHECK_SCAN_TICKS + 2u * config.max_bounces * config.max_bounce_ticks;
+    *events = 0;
+    for (uint16_t i = 0; i < CHECK_BUTTONS; i++) {
+        button_latency_snapshot_t snap;
+        if (ButtonLatency_Snapshot(&latency[i], &snap) != BUTTON_OK || snap.max_ticks > bound) {
+            printf("FAIL seed 0x%08lx: button %u max latency %lu ticks, bound %lu\n", (unsigned long)seed, (unsigned)i,
+                   (unsigned long)snap.max_ticks, (unsigned long)bound);
+            return false;
+        }
+#if BUTTON_FEATURE_DISPATCH
+        if (snap.count != measured_events[i]) {
+            printf("FAIL seed 0x%08lx: button %u recorded %lu latencies for %lu events\n", (unsigned long)seed, (unsigned)i,
+                   (unsigned long)snap.count, (unsigned long)measured_events[i]);
+            return false;
+        }
+#endif
+        *events += snap.count;
+    }
+    return true;
+}
+
+/* A snapshot of count n holds exactly records 0 .. n-1 of the writer's sequence */
+static bool snapshot_matches(const button_latency_snapshot_t* snap) {
+    uint32_t n = snap->count;
+    uint32_t rounds = n / CHECK_RECORD_PERIOD;
+    uint32_t rest = n % CHECK_RECORD_PERIOD;
+    uint64_t sum = (uint64_t)rounds * (CHECK_RECORD_PERIOD * (CHECK_RECORD_PERIOD - 1u) / 2u) + (uint64_t)rest * (rest - 1u) / 2u;
+    uint32_t max_ticks = (n == 0) ? 0u : (rounds > 0 ? CHECK_RECORD_PERIOD - 1u : rest - 1u);
+    uint32_t total = 0;
+
+    if (snap->sum_ticks != sum || snap->max_ticks != max_ticks) return false;
+    for (uint8_t b = 0; b < BUTTON_LATENCY_BUCKETS; b++) {
+        total += snap->buckets[b];
+    }
+    if (total != n) return false;
+    if (n == 0) return true;
+
+    uint32_t p100;
+    return ButtonLatency_Percentile(snap, 100, &p100) == BUTTON_OK && p100 == snap->max_ticks;
+}
+
+static void* writer_main(void* arg) {
+    (void)arg;
+    for (uint32_t i = 0; i < CHECK_RECORDS; i++) {
+        ButtonLatency_Record(&shared_latency, i % CHECK_RECORD_PERIOD);
+        if (i % CHECK_YIELD_RECORDS == 0) sched_yield();    /* Lets the reader in on a single CPU */
+    }
+    atomic_store(&writer_done, true);
+    return NULL;
+}
+
+static bool snapshots_consistent(uint32_t seed, uint32_t* taken) {
+    pthread_t writer;
+    bool ok = true;
+
+    button_latency_snapshot_t snap;
+    atomic_init(&shared_latency.seq, 0);
+    ButtonLatency_Reset(&shared_latency);
+
+    /* A write left open (odd sequence) must fail the snapshot, not return a half-written copy */
+    atomic_store(&shared_latency.seq, 1u);
+    if (ButtonLatency_Snapshot(&shared_latency, &snap) != BUTTON_ERR_UNKNOWN) {
+        printf("FAIL seed 0x%08lx: snapshot taken during a write\n", (unsigned long)seed);
+        return false;
+    }
+    atomic_store(&shared_latency.seq, 2u);
+
+    atomic_store(&writer_done, false);
+    if (pthread_create(&writer, NULL, writer_main, NULL) != 0) {
+        printf("FAIL seed 0x%08lx: thread\n", (unsigned long)seed);
+        return false;
+    }
+
+    *taken = 0;
+    while (ok && !atomic_load(&writer_done)) {
+        button_error_t err = ButtonLatency_Snapshot(&shared_latency, &snap);
+        if (err == BUTTON_ERR_UNKNOWN) continue;    /* Every attempt overlapped a write */
+        if (err != BUTTON_OK || !snapshot_matches(&snap)) {
+            printf("FAIL seed 0x%08lx: snapshot of %lu records torn (sum %llu, max %lu)\n", (unsigned long)seed,
+                   (unsigned long)snap.count, (unsigned long long)snap.sum_ticks, (unsigned long)snap.max_ticks);
+            ok = false;
+        }
+        (*taken)++;
+        if (check_rand() % 4u == 0) sched_yield();
+    }
+    pthread_join(writer, NULL);
+    return ok;
+}
+
+static bool run_one(uint32_t seed) {
+    uint32_t events = 0;
+    uint32_t taken = 0;
+
+    rng_state = seed | 1u;
+    if (!stale_edge_dropped(seed)) return false;
+    if (!workload_bounded(seed, &events)) return false;
+    if (!snapshots_consistent(seed, &taken)) return false;
+
+    printf("ok   seed 0x%08lx: %lu latencies measured, %lu snapshots\n", (unsigned long)seed,
+           (unsigned long)events, (unsigned long)taken);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    uint32_t runs = 4;
+    uint32_t seed = 0x1234567u;
+    bool all_ok = true;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            runs = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            printf("usage: %s [-n runs] [-s seed]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    for (uint32_t r = 0; r < runs && all_ok; r++) {
+        all_ok = run_one(seed + r * 0x9E3779B9u);
+    }
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,313 @@
+/**
+ * @file    button_monitor_check.c
+ * @author  datngyB
+ * @brief   Stress of the monitor page: a forked reader hammers it during bank sweeps.
+ * @version 0.1.0
+ * @date    2026-10-18
+ * * @copyright Copyright (c) 2026
+ *
+ * The parent publishes a bank of CHECK_BUTTONS buttons, driven by a panel
+ * workload (button_workload.h), on a page from ButtonMonitor_Create and
+ * sweeps it once per tick. After every sweep it logs a hash of the whole
+ * page, indexed by the sweep tick, in memory shared with the child.
+ *
+ * The child attaches with ButtonMonitor_Attach and reads every slot with
+ * ButtonMonitor_Read in a loop until the parent is done. Every copy must
+ * hash to what the parent logged for the tick it came with (a quiet sweep
+ * changes no slot, so its tick still matches), and the tick must never go
+ * backwards. Reads that gave up on a sweep in progress are only counted.
+ *
+ * Before and after the sweeps, a second Create on the same name must fail
+ * and leave the live page to its publisher; one that takes the name over
+ * must succeed. ButtonMonitor_Unlink then removes the name while the page
+ * is still mapped: Attach must fail with ENOENT, a second Unlink must report
+ * the name missing, and the old mapping must still read.
+ *
+ * Usage: button_monitor_check [-n runs] [-s seed] [-t sweeps]
+ * Build: cc -O2 -Iinclude -Itools button_static.c button_bank.c button_latency.c linux/button_monitor.c tools/button_monitor_check.c tools/button_workload.c -lm
+ * Exit status is non-zero on the first mismatch.
+ */
+
+#define     _GNU_SOURCE
+#include    <stdbool.h>
+#include    <stdint.h>
+#include    <stdio.h>
+#include    <stdlib.h>
+#include    <string.h>
+#include    <errno.h>
+#include    <sched.h>
+#include    <unistd.h>
+#include    <sys/mman.h>
+#include    <sys/wait.h>
+#include    "button_bank.h"
+#include    "button_monitor.h"
+#include    "button_workload.h"
+
+#define CHECK_BUTTONS               32u
+#define CHECK_DEFAULT_SWEEPS        400000u
+#define CHECK_MEAN_GAP_TICKS        2u      /* Busy panel: most sweeps write the page */
+
+/* Shared with the reader: hash of the page after each sweep, and what the reader saw */
+typedef struct {
+    atomic_uint_least32_t logged;   /**< Sweeps whose hash is in log[] (the initial page is entry 0) */
+    atomic_bool done;               /**< Set by the parent after its last sweep */
+    uint32_t reads;
+    uint32_t stalls;
+    uint32_t changes;               /**< Reads whose hash differed from the previous read */
+    uint32_t log[];
+} check_shared_t;
+
+static const button_profile_t check_profile = BUTTON_PROFILE_DEFAULT(NULL, 0);
+static bool levels[CHECK_BUTTONS];
+static uint32_t sweep_tick;
+
+static bool check_read_pin(uint32_t gpio_num);
+static uint32_t check_get_tick(void);
+static uint32_t hash_slot(uint32_t h, uint32_t status, uint32_t press_start, uint32_t event_tick);
+static uint32_t hash_page(const button_monitor_page_t* page);
+static int run_reader(const char* name, check_shared_t* shared, uint32_t start, uint32_t sweeps);
+static bool create_refused(const char* name, const button_monitor_page_t* live);
+static bool run_one(uint32_t seed, uint32_t sweeps);
+
+
+static bool check_read_pin(uint32_t gpio_num) {
+    return levels[gpio_num];
+}
+
+static uint32_t check_get_tick(void) {
+    return sweep_tick;
+}
+
+/* FNV-1a over the slot words, as laid out in the page */
+static uint32_t hash_slot(uint32_t h, uint32_t status, uint32_t press_start, uint32_t event_tick) {
+    const uint32_t words[3] = { status, press_start, event_tick };
+    for (int w = 0; w < 3; w++) {
+        for (int b = 0; b < 32; b += 8) {
+            h ^= (words[w] >> b) & 0xFFu;
+            h *= 16777619u;
+        }
+    }
+    return h;
+}
+
+/* Writer side: the page cannot change under the sweeping thread */
+static uint32_t hash_page(const button_monitor_page_t* page) {
+    uint32_t h = 2166136261u;
+    for (uint16_t i = 0; i < page->count; i++) {
+        const button_monitor_slot_t *slot = &page->slots[i];
+        h = hash_slot(h, (uint32_t)atomic_load_explicit(&slot->status, memory_order_relaxed),
+                      (uint32_t)atomic_load_explicit(&slot->press_start_tick, memory_order_relaxed),
+                      (uint32_t)atomic_load_explicit(&slot->last_event_tick, memory_order_relaxed));
+    }
+    return h;
+}
+
+/* Child process: exit status 0 when every read matched */
+static int run_reader(const char* name, check_shared_t* shared, uint32_t start, uint32_t sweeps) {
+    button_monitor_map_t map;
+    button_monitor_sample_t samples[CHECK_BUTTONS];
+    uint32_t last_tick = start;
+    uint32_t last_hash = 0;
+
+    while (ButtonMonitor_Attach(&map, name) != BUTTON_OK) {
+        if (atomic_load(&shared->done)) return 1;
+        sched_yield();
+    }
+
+    while (!atomic_load_explicit(&shared->done, memory_order_acquire)) {
+        uint32_t tick;
+        button_error_t err = ButtonMonitor_Read(map.page, 0, CHECK_BUTTONS, samples, &tick);
+        if (err == BUTTON_ERR_UNKNOWN) {
+            shared->stalls++;
+            continue;
+        }
+        if (err != BUTTON_OK) {
+            printf("FAIL reader: read error %d\n", (int)err);
+            return 1;
+        }
+
+        uint32_t sweep = tick - start;
+        if ((int32_t)(tick - last_tick) < 0 || sweep > sweeps) {
+            printf("FAIL reader: tick +%lu after +%lu\n", (unsigned long)sweep, (unsigned long)(last_tick - start));
+            return 1;
+        }
+        last_tick = tick;
+
+        uint32_t h = 2166136261u;
+        for (uint16_t i = 0; i < CHECK_BUTTONS; i++) {
+            h = hash_slot(h, BUTTON_MONITOR_STATUS(samples[i].state, samples[i].last_event),
+                          samples[i].press_start_tick, samples[i].last_event_tick);
+        }
+        /* The sweep may not be logged yet: its page is visible before the writer hashes it */
+        while (atomic_load_explicit(&shared->logged, memory_order_acquire) <= sweep) sched_yield();
+        if (h != shared->log[sweep]) {
+            printf("FAIL reader: torn copy at tick +%lu\n", (unsigned long)sweep);
+            return 1;
+        }
+        if (h != last_hash) shared->changes++;
+        last_hash = h;
+        shared->reads++;
+    }
+    ButtonMonitor_Close(&map);
+    return 0;
+}
+
+/* A second publisher on the name is turned away and the live page is untouched */
+static bool create_refused(const char* name, const button_monitor_page_t* live) {
+    button_monitor_map_t other;
+    button_monitor_map_t seen;
+    button_monitor_sample_t sample;
+
+    if (ButtonMonitor_Create(&other, name, CHECK_BUTTONS, false) == BUTTON_OK) {
+        ButtonMonitor_Close(&other);
+        return false;
+    }
+    if (ButtonMonitor_Attach(&seen, name) != BUTTON_OK) return false;
+    bool same = ButtonMonitor_Read(seen.page, 0, 1, &sample, NULL) == BUTTON_OK &&
+                seen.page->count == live->count &&
+                atomic_load(&seen.page->tick) == atomic_load(&live->tick);
+    ButtonMonitor_Close(&seen);
+    return same;
+}
+
+/* The name is gone for new readers, and the mapping still reads */
+static bool unlinked(const char* name, const button_monitor_page_t* live) {
+    button_monitor_map_t seen;
+    button_monitor_sample_t sample;
+
+    if (ButtonMonitor_Unlink(name) != BUTTON_OK) return false;
+    errno = 0;
+    if (ButtonMonitor_Attach(&seen, name) != BUTTON_ERR_HW_FAIL || errno != ENOENT) {
+        ButtonMonitor_Close(&seen);
+        return false;
+    }
+    if (ButtonMonitor_Unlink(name) != BUTTON_ERR_NOT_INIT) return false;
+    return ButtonMonitor_Read(live, 0, 1, &sample, NULL) == BUTTON_OK;
+}
+
+static bool run_one(uint32_t seed, uint32_t sweeps) {
+    button_workload_config_t config;
+    button_workload_t gen;
+    button_workload_edge_t edge;
+    button_bank_entry_t entries[CHECK_BUTTONS];
+    button_bank_state_t states[CHECK_BUTTONS];
+    button_bank_t bank;
+    button_monitor_map_t map;
+    char name[64];
+
+    snprintf(name, sizeof(name), "/button_monitor_check.%ld", (long)getpid());
+    sweep_tick = seed;
+    uint32_t start = sweep_tick;
+    for (uint32_t i = 0; i < CHECK_BUTTONS; i++) {
+        entries[i] = (button_bank_entry_t){ .gpio_num = i, .active_level = BUTTON_ACTIVE_HIGH, .profile = 0 };
+        levels[i] = false;
+    }
+
+    size_t shared_size = sizeof(check_shared_t) + ((size_t)sweeps + 1u) * sizeof(uint32_t);
+    check_shared_t *shared = mmap(NULL, shared_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared == MAP_FAILED) {
+        printf("FAIL seed 0x%08lx: shared log\n", (unsigned long)seed);
+        return false;
+    }
+
+    ButtonWorkload_DefaultConfig(&config, seed, CHECK_BUTTONS, sweeps);
+    config.mean_gap_ticks = CHECK_MEAN_GAP_TICKS;
+    if (ButtonWorkload_Init(&gen, &config) != BUTTON_OK ||
+        Button_BankInit(&bank, entries, states, CHECK_BUTTONS, &check_profile, 1, check_read_pin, check_get_tick) != BUTTON_OK ||
+        ButtonMonitor_Create(&map, name, CHECK_BUTTONS, true) != BUTTON_OK ||
+        Button_BankConfigMonitor(&bank, map.page) != BUTTON_OK) {
+        printf("FAIL seed 0x%08lx: setup\n", (unsigned long)seed);
+        munmap(shared, shared_size);
+        return false;
+    }
+    shared->log[0] = hash_page(map.page);
+    atomic_store(&shared->logged, 1u);
+
+    bool ok = create_refused(name, map.page);
+    if (!ok) printf("FAIL seed 0x%08lx: second Create on a live page was not refused\n", (unsigned long)seed);
+
+    fflush(stdout);
+    pid_t child = ok ? fork() : -1;
+    if (child == 0) _exit(run_reader(name, shared, start, sweeps));
+    if (ok && child < 0) {
+        printf("FAIL seed 0x%08lx: fork\n", (unsigned long)seed);
+        ok = false;
+    }
+
+    bool have_edge = ok && ButtonWorkload_Next(&gen, &edge);
+    for (uint32_t t = 1; ok && t <= sweeps; t++) {
+        while (have_edge && edge.tick <= t) {
+            levels[edge.index] = edge.pressed;
+            have_edge = ButtonWorkload_Next(&gen, &edge);
+        }
+        sweep_tick = start + t;
+        Button_BankUpdate(&bank);
+        shared->log[t] = hash_page(map.page);
+        atomic_store_explicit(&shared->logged, t + 1u, memory_order_release);
+    }
+    atomic_store_explicit(&shared->done, true, memory_order_release);
+
+    if (child > 0) {
+        int status = 0;
+        waitpid(child, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            printf("FAIL seed 0x%08lx: reader mismatch after %lu reads\n", (unsigned long)seed, (unsigned long)shared->reads);
+            ok = false;
+        }
+    }
+    if (ok && !create_refused(name, map.page)) {
+        printf("FAIL seed 0x%08lx: second Create after the sweeps was not refused\n", (unsigned long)seed);
+        ok = false;
+    }
+
+    button_monitor_map_t next;
+    if (ok && ButtonMonitor_Create(&next, name, CHECK_BUTTONS, true) != BUTTON_OK) {
+        printf("FAIL seed 0x%08lx: take-over Create refused\n", (unsigned long)seed);
+        ok = false;
+    } else if (ok) {
+        ButtonMonitor_Close(&next);
+    }
+
+    if (ok && !unlinked(name, map.page)) {
+        printf("FAIL seed 0x%08lx: the name outlived ButtonMonitor_Unlink\n", (unsigned long)seed);
+        ok = false;
+    }
+
+    if (ok) {
+        /* The sequence moves by two for every sweep that wrote the page */
+        uint32_t writes = (uint32_t)atomic_load(&map.page->seq) / 2u;
+        printf("ok   seed 0x%08lx: %lu sweeps (%lu wrote), %lu reads (%lu saw a new page), %lu gave up on a sweep\n",
+               (unsigned long)seed, (unsigned long)sweeps, (unsigned long)writes, (unsigned long)shared->reads,
+               (unsigned long)shared->changes, (unsigned long)shared->stalls);
+    }
+    ButtonMonitor_Close(&map);
+    ButtonMonitor_Unlink(name);     /* Already gone unless a step above failed */
+    munmap(shared, shared_size);
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    uint32_t runs = 1;
+    uint32_t seed = 0x1234567u;
+    uint32_t sweeps = CHECK_DEFAULT_SWEEPS;
+    bool all_ok = true;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            runs = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            sweeps = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            printf("usage: %s [-n runs] [-s seed] [-t sweeps]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (sweeps == 0) sweeps = 1;
+
+    for (uint32_t r = 0; r < runs && all_ok; r++) {
+        all_ok = run_one(seed + r * 0x9E3779B9u, sweeps);
+    }
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,327 @@
+#include    <stdbool.h>
+#include    <stdint.h>
+#include    <stddef.h>
+#include    "button_oracle.h"
+#include    "button_workload.h"
+
+#define ORACLE_WORKLOAD_GAP_TICKS   100u    /* Mean gap between presses on the whole panel */
+
+/* Event log of one engine for the tick being compared */
+typedef struct {
+    uint16_t index[BUTTON_ORACLE_MAX_EVENTS];
+    button_event_t event[BUTTON_ORACLE_MAX_EVENTS];
+    uint32_t count;
+    bool overflow;
+} oracle_log_t;
+
+/* Reference engine: plain button_t instances driven by Button_Update */
+typedef struct {
+    button_t buttons[BUTTON_ORACLE_MAX_BUTTONS];
+    bool latches[BUTTON_ORACLE_MAX_BUTTONS][BUTTON_ORACLE_MAX_STAGES];
+    uint16_t lane[BUTTON_ORACLE_MAX_BUTTONS];
+    uint16_t count;
+    button_oracle_emit_fn emit;
+    void *emit_ctx;
+} oracle_reference_t;
+
+/* Button_Update pulls level and tick through context-free hooks */
+static const bool *ref_levels;
+static uint32_t ref_tick;
+static oracle_reference_t *ref_active;
+
+static oracle_reference_t reference_instance;
+static oracle_reference_t mirror_instance;
+static oracle_log_t expected_log;
+static oracle_log_t actual_log;
+
+static bool ref_read_pin(uint32_t pin_mask);
+static uint32_t ref_get_tick(void);
+#if BUTTON_FEATURE_DISPATCH
+static void ref_callback(button_event_t event, void* context);
+#endif
+static bool ref_reset(void* self, uint16_t count, const button_stage_config_t* stages, uint8_t stage_count,
+                      uint32_t tick, button_oracle_emit_fn emit, void* emit_ctx);
+static void ref_step(void* self, const bool* pressed, uint32_t tick);
+static void log_event(uint16_t index, button_event_t event, void* context);
+static bool compare_logs(uint32_t offset, button_oracle_report_t* report);
+static uint32_t rng_next(uint32_t* state);
+static uint32_t rng_range(uint32_t* state, uint32_t lo, uint32_t hi);
+static uint32_t random_duration(uint32_t* state, bool pressed, const button_oracle_trace_buf_t* buf, uint8_t stage_count);
+static uint8_t random_stages(uint32_t* state, button_oracle_trace_buf_t* buf);
+
+static const button_oracle_engine_t reference_engine = {
+    .name = "reference",
+    .self = &reference_instance,
+    .reset = ref_reset,
+    .step = ref_step,
+};
+
+/* A second, independent reference instance; used to self-check the harness and traces */
+static const button_oracle_engine_t mirror_engine = {
+    .name = "reference-mirror",
+    .self = &mirror_instance,
+    .reset = ref_reset,
+    .step = ref_step,
+};
+
+const button_oracle_engine_t* ButtonOracle_ReferenceEngine(void) {
+    return &mirror_engine;
+}
+
+static bool ref_read_pin(uint32_t pin_mask) {
+    return ref_levels[pin_mask];
+}
+
+static uint32_t ref_get_tick(void) {
+    return ref_tick;
+}
+
+#if BUTTON_FEATURE_DISPATCH
+static void ref_callback(button_event_t event, void* context) {
+    const uint16_t *lane = (const uint16_t*)context;
+    ref_active->emit(*lane, event, ref_active->emit_ctx);
+}
+#endif
+
+static bool ref_reset(void* self, uint16_t count, const button_stage_config_t* stages, uint8_t stage_count,
+                      uint32_t tick, button_oracle_emit_fn emit, void* emit_ctx) {
+    oracle_reference_t *ref = (oracle_reference_t*)self;
+    if (count > BUTTON_ORACLE_MAX_BUTTONS || stage_count > BUTTON_ORACLE_MAX_STAGES) return false;
+
+    ref->count = count;
+    ref->emit = emit;
+    ref->emit_ctx = emit_ctx;
+    ref_tick = tick;
+    for (uint16_t i = 0; i < count; i++) {
+        ref->lane[i] = i;
+        if (Button_Init(&ref->buttons[i], i, BUTTON_ACTIVE_HIGH, ref_read_pin, ref_get_tick) != BUTTON_OK) return false;
+        if (stage_count > 0) {
+#if BUTTON_FEATURE_STAGES
+            for (uint8_t s = 0; s < stage_count; s++) ref->latches[i][s] = false;
+            if (Button_ConfigStages(&ref->buttons[i], stages, ref->latches[i], stage_count) != BUTTON_OK) return false;
+#else
+            (void)stages;
+            return false;
+#endif
+        }
+#if BUTTON_FEATURE_DISPATCH
+        Button_RegisterHandler(&ref->buttons[i], ref_callback, &ref->lane[i]);
+#endif
+    }
+    return true;
+}
+
+static void ref_step(void* self, const bool* pressed, uint32_t tick) {
+    oracle_reference_t *ref = (oracle_reference_t*)self;
+    ref_levels = pressed;
+    ref_tick = tick;
+    ref_active = ref;
+    for (uint16_t i = 0; i < ref->count; i++) {
+#if BUTTON_FEATURE_DISPATCH
+        Button_Update(&ref->buttons[i]);
+#else
+        /* Polled: only the last event of the update is visible */
+        button_event_mask_t events;
+        Button_UpdateEx(&ref->buttons[i], &events);
+        if (events) ref->emit(i, ref->buttons[i].last_event, ref->emit_ctx);
+#endif
+    }
+}
+
+static void log_event(uint16_t index, button_event_t event, void* context) {
+    oracle_log_t *log = (oracle_log_t*)context;
+    if (log->count >= BUTTON_ORACLE_MAX_EVENTS) {
+        log->overflow = true;
+        return;
+    }
+    log->index[log->count] = index;
+    log->event[log->count] = event;
+    log->count++;
+}
+
+static bool compare_logs(uint32_t offset, button_oracle_report_t* report) {
+    uint32_t n = (expected_log.count > actual_log.count) ? expected_log.count : actual_log.count;
+
+    for (uint32_t i = 0; i < n; i++) {
+        bool have_expected = i < expected_log.count;
+        bool have_actual = i < actual_log.count;
+        if (have_expected && have_actual &&
+            expected_log.index[i] == actual_log.index[i] && expected_log.event[i] == actual_log.event[i]) {
+            continue;
+        }
+        report->match = false;
+        report->mismatch_tick = offset;
+        report->mismatch_position = i;
+        report->expected_index = have_expected ? expected_log.index[i] : 0;
+        report->expected_event = have_expected ? expected_log.event[i] : BUTTON_EVENT_NONE;
+        report->actual_index = have_actual ? actual_log.index[i] : 0;
+        report->actual_event = have_actual ? actual_log.event[i] : BUTTON_EVENT_NONE;
+        return false;
+    }
+    report->events_compared += n;
+    return true;
+}
+
+button_error_t ButtonOracle_Run(const button_oracle_engine_t* candidate, const button_oracle_trace_t* trace, button_oracle_report_t* report) {
+    if (!candidate || !candidate->reset || !candidate->step || !trace || !report) return BUTTON_ERR_INVALID_ARG;
+    if (candidate->self == reference_engine.self) return BUTTON_ERR_INVALID_ARG;
+    if (trace->button_count == 0 || trace->button_count > BUTTON_ORACLE_MAX_BUTTONS) return BUTTON_ERR_INVALID_ARG;
+    if (trace->edge_count > 0 && !trace->edges) return BUTTON_ERR_INVALID_ARG;
+    if (trace->stage_count > BUTTON_ORACLE_MAX_STAGES || (trace->stage_count > 0 && !trace->stages)) return BUTTON_ERR_INVALID_STAGES;
+
+    bool levels[BUTTON_ORACLE_MAX_BUTTONS] = { false };
+    uint32_t next_edge = 0;
+
+    *report = (button_oracle_report_t){ .match = true };
+
+    if (!reference_engine.reset(reference_engine.self, trace->button_count, trace->stages, trace->stage_count,
+                                trace->start_tick, log_event, &expected_log)) return BUTTON_ERR_INVALID_STAGES;
+    if (!candidate->reset(candidate->self, trace->button_count, trace->stages, trace->stage_count,
+                          trace->start_tick, log_event, &actual_log)) return BUTTON_ERR_INVALID_STAGES;
+
+    for (uint32_t offset = 0; offset < trace->duration; offset++) {
+        while (next_edge < trace->edge_count && trace->edges[next_edge].tick <= offset) {
+            const button_oracle_edge_t *e = &trace->edges[next_edge++];
+            if (e->index < trace->button_count) levels[e->index] = e->pressed;
+        }
+
+        expected_log.count = 0;
+        expected_log.overflow = false;
+        actual_log.count = 0;
+        actual_log.overflow = false;
+
+        uint32_t tick = trace->start_tick + offset;
+        reference_engine.step(reference_engine.self, levels, tick);
+        candidate->step(candidate->self, levels, tick);
+
+        report->ticks_compared = offset + 1;
+        if (expected_log.overflow || actual_log.overflow) return BUTTON_ERR_UNKNOWN;
+        if (!compare_logs(offset, report)) break;
+    }
+    return BUTTON_OK;
+}
+
+/* xorshift32: traces are reproducible from the seed alone */
+static uint32_t rng_next(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static uint32_t rng_range(uint32_t* state, uint32_t lo, uint32_t hi) {
+    return lo + (rng_next(state) % (hi - lo + 1u));
+}
+
+/*
+ * Segment lengths are biased towards the FSM boundaries (debounce, long press,
+ * hold period, stage thresholds), where off-by-one differences show up.
+ */
+static uint32_t random_duration(uint32_t* state, bool pressed, const button_oracle_trace_buf_t* buf, uint8_t stage_count) {
+    uint32_t kind = rng_range(state, 0, 99);
+
+    if (kind < 15) return rng_range(state, 1, 3);   /* glitch / bounce */
+    if (kind < 30) return rng_range(state, BUTTON_DEBOUNCE_TICKS - 2, BUTTON_DEBOUNCE_TICKS + 2);
+    if (!pressed)  return rng_range(state, 4, 3 * BUTTON_DEBOUNCE_TICKS);
+    if (kind < 55) return rng_range(state, BUTTON_DEBOUNCE_TICKS, BUTTON_LONG_PRESS_TICKS / 2);
+    if (kind < 70) return rng_range(state, BUTTON_DEBOUNCE_TICKS + BUTTON_LONG_PRESS_TICKS - 3,
+                                    BUTTON_DEBOUNCE_TICKS + BUTTON_LONG_PRESS_TICKS + 3);
+    if (kind < 85 || stage_count == 0) {
+        return rng_range(state, 2 * BUTTON_LONG_PRESS_TICKS, 2 * BUTTON_LONG_PRESS_TICKS + 5 * BUTTON_HOLD_TICKS);
+    }
+    uint32_t thr = buf->stages[rng_range(state, 0, stage_count - 1u)].threshold;
+    return BUTTON_DEBOUNCE_TICKS + BUTTON_LONG_PRESS_TICKS + thr + rng_range(state, 0, 4) - 2u;
+}
+
+/* Random stage table: strictly increasing thresholds around the hold phase; none without stage support */
+static uint8_t random_stages(uint32_t* state, button_oracle_trace_buf_t* buf) {
+    uint8_t stage_count = BUTTON_FEATURE_STAGES ? (uint8_t)rng_range(state, 0, BUTTON_ORACLE_MAX_STAGES / 2) : 0u;
+    uint32_t thr = 0;
+
+    for (uint8_t s = 0; s < stage_count; s++) {
+        thr += rng_range(state, 1, 2 * BUTTON_LONG_PRESS_TICKS);
+        buf->stages[s].threshold = thr;
+        buf->stages[s].event = (button_event_t)rng_range(state, BUTTON_EVENT_PRESSED, BUTTON_EVENT_MAX - 1);
+        /* HOLD interval: mostly inherited, sometimes stopped, otherwise a new rate */
+        uint32_t hold_kind = rng_range(state, 0, 9);
+        buf->stages[s].hold_ticks = (hold_kind < 4) ? 0u : (hold_kind < 6) ? BUTTON_HOLD_OFF : rng_range(state, 1, 3 * BUTTON_HOLD_TICKS);
+    }
+    return stage_count;
+}
+
+button_error_t ButtonOracle_RandomTrace(button_oracle_trace_t* trace, button_oracle_trace_buf_t* buf, uint32_t seed, uint16_t button_count, uint32_t duration) {
+    if (!trace || !buf || !buf->edges || buf->capacity == 0) return BUTTON_ERR_INVALID_ARG;
+    if (button_count == 0 || button_count > BUTTON_ORACLE_MAX_BUTTONS) return BUTTON_ERR_INVALID_ARG;
+
+    uint32_t state = seed ? seed : 1u;
+    uint32_t next_toggle[BUTTON_ORACLE_MAX_BUTTONS];
+    bool level[BUTTON_ORACLE_MAX_BUTTONS] = { false };
+
+    uint8_t stage_count = random_stages(&state, buf);
+
+    for (uint16_t i = 0; i < button_count; i++) {
+        next_toggle[i] = rng_range(&state, 0, 2 * BUTTON_LONG_PRESS_TICKS);
+    }
+
+    uint32_t n = 0;
+    for (uint32_t t = 0; t < duration && n < buf->capacity; t++) {
+        for (uint16_t i = 0; i < button_count && n < buf->capacity; i++) {
+            if (next_toggle[i] != t) continue;
+            level[i] = !level[i];
+            buf->edges[n++] = (button_oracle_edge_t){ .tick = t, .index = i, .pressed = level[i] };
+            next_toggle[i] = t + random_duration(&state, level[i], buf, stage_count);
+        }
+    }
+
+    *trace = (button_oracle_trace_t){
+        .edges = buf->edges,
+        .edge_count = n,
+        .button_count = button_count,
+        .start_tick = rng_next(&state),
+        .duration = duration,
+        .stages = (stage_count > 0) ? buf->stages : NULL,
+        .stage_count = stage_count,
+    };
+    return BUTTON_OK;
+}
+
+/*
+ * Realistic traffic (button_workload.h): skewed Poisson presses with bounce
+ * and glitches, over a random stage table. The panel is kept busy so that a
+ * short trace still crosses every threshold many times.
+ */
+button_error_t ButtonOracle_WorkloadTrace(button_oracle_trace_t* trace, button_oracle_trace_buf_t* buf, uint32_t seed, uint16_t button_count, uint32_t duration) {
+    if (!trace || !buf || !buf->edges || buf->capacity == 0) return BUTTON_ERR_INVALID_ARG;
+    if (button_count == 0 || button_count > BUTTON_ORACLE_MAX_BUTTONS) return BUTTON_ERR_INVALID_ARG;
+
+    uint32_t state = seed ? seed : 1u;
+    uint8_t stage_count = random_stages(&state, buf);
+    button_workload_config_t config;
+    button_workload_t gen;
+    button_workload_edge_t edge;
+
+    ButtonWorkload_DefaultConfig(&config, rng_next(&state), button_count, duration);
+    config.mean_gap_ticks = ORACLE_WORKLOAD_GAP_TICKS;
+    config.stages = buf->stages;
+    config.stage_count = stage_count;
+    button_error_t err = ButtonWorkload_Init(&gen, &config);
+    if (err != BUTTON_OK) return err;
+
+    uint32_t n = 0;
+    while (n < buf->capacity && ButtonWorkload_Next(&gen, &edge)) {
+        buf->edges[n++] = (button_oracle_edge_t){ .tick = edge.tick, .index = edge.index, .pressed = edge.pressed };
+    }
+
+    *trace = (button_oracle_trace_t){
+        .edges = buf->edges,
+        .edge_count = n,
+        .button_count = button_count,
+        .start_tick = rng_next(&state),
+        .duration = duration,
+        .stages = (stage_count > 0) ? buf->stages : NULL,
+        .stage_count = stage_count,
+    };
+    return BUTTON_OK;
+}
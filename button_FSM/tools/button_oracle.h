@@ -0,0 +1,93 @@
+/**
+ * @file    button_oracle.h
+ * @author  datngyB
+ * @brief   Differential test oracle: optimized engines vs. the reference FSM.
+ * @version 0.1.0
+ * @date    2026-10-18
+ * * @copyright Copyright (c) 2026
+ *
+ * The reference is button_static.c driven through Button_Update, one button_t
+ * per lane. A candidate engine is fed the same logical levels on every tick and
+ * must emit the same (button, event) sequence, in the same order, on the same
+ * tick. The first divergence is reported.
+ *
+ * With BUTTON_FEATURE_DISPATCH=0 there are no handlers: each engine emits,
+ * per button and tick, the last event it dispatched, as a polling application
+ * sees it (Button_UpdateEx and last_event; the bank's live state page).
+ */
+
+#ifndef BUTTON_ORACLE_H
+#define BUTTON_ORACLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "button_static.h"
+
+#define BUTTON_ORACLE_MAX_BUTTONS   64
+#define BUTTON_ORACLE_MAX_STAGES    8
+#define BUTTON_ORACLE_MAX_EVENTS    (BUTTON_ORACLE_MAX_BUTTONS * (BUTTON_ORACLE_MAX_STAGES + 2))
+
+/* Event sink handed to an engine at reset */
+typedef void (*button_oracle_emit_fn)(uint16_t index, button_event_t event, void* context);
+
+/* Engine under test. All buttons are active high, so level == pressed. */
+typedef struct {
+    const char *name;
+    void *self;             /**< Engine instance passed back to every hook */
+
+    /** Bring all buttons to power-on state at @p tick with the given stage table (may be empty) */
+    bool (*reset)(void* self, uint16_t count, const button_stage_config_t* stages, uint8_t stage_count,
+                  uint32_t tick, button_oracle_emit_fn emit, void* emit_ctx);
+    /** Sample every button once at @p tick; pressed[i] is the level of button i */
+    void (*step)(void* self, const bool* pressed, uint32_t tick);
+} button_oracle_engine_t;
+
+/* One level change of a trace */
+typedef struct {
+    uint32_t tick;          /**< Offset from the trace start tick */
+    uint16_t index;         /**< Button lane */
+    bool pressed;           /**< Level from this tick on */
+} button_oracle_edge_t;
+
+/* Randomized or recorded input */
+typedef struct {
+    const button_oracle_edge_t *edges;  /**< Sorted by tick */
+    uint32_t edge_count;
+    uint16_t button_count;
+    uint32_t start_tick;                /**< Absolute tick of offset 0 (exercises wrap-around) */
+    uint32_t duration;                  /**< Ticks to replay */
+    const button_stage_config_t *stages;
+    uint8_t stage_count;
+} button_oracle_trace_t;
+
+typedef struct {
+    bool match;
+    uint32_t ticks_compared;
+    uint64_t events_compared;
+
+    /* Valid when match == false */
+    uint32_t mismatch_tick;             /**< Offset from the trace start tick */
+    uint32_t mismatch_position;         /**< Position within that tick's event list */
+    uint16_t expected_index;
+    button_event_t expected_event;      /**< BUTTON_EVENT_NONE: reference emitted fewer events */
+    uint16_t actual_index;
+    button_event_t actual_event;        /**< BUTTON_EVENT_NONE: candidate emitted fewer events */
+} button_oracle_report_t;
+
+/* Storage needed by the randomized trace generator */
+typedef struct {
+    button_oracle_edge_t *edges;
+    uint32_t capacity;
+    button_stage_config_t stages[BUTTON_ORACLE_MAX_STAGES];
+} button_oracle_trace_buf_t;
+
+// API
+button_error_t ButtonOracle_Run(const button_oracle_engine_t* candidate, const button_oracle_trace_t* trace, button_oracle_report_t* report);
+button_error_t ButtonOracle_RandomTrace(button_oracle_trace_t* trace, button_oracle_trace_buf_t* buf, uint32_t seed, uint16_t button_count, uint32_t duration);
+button_error_t ButtonOracle_WorkloadTrace(button_oracle_trace_t* trace, button_oracle_trace_buf_t* buf, uint32_t seed, uint16_t button_count, uint32_t duration);
+const button_oracle_engine_t* ButtonOracle_ReferenceEngine(void);   // independent reference instance, for self-checks
+
+// Engines under test
+const button_oracle_engine_t* ButtonOracle_BankEngine(void);
+
+#endif // BUTTON_ORACLE_H
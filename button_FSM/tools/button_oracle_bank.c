@@ -0,0 +1,99 @@
+#include    <stdbool.h>
+#include    <stdint.h>
+#include    <stddef.h>
+#include    "button_oracle.h"
+#include    "button_bank.h"
+#include    "button_monitor.h"
+
+/* Bank engine adapter: one bank entry per lane, default timing profile */
+typedef struct {
+    button_bank_t bank;
+    button_bank_entry_t entries[BUTTON_ORACLE_MAX_BUTTONS];
+    button_bank_state_t states[BUTTON_ORACLE_MAX_BUTTONS];
+    button_profile_t profile;
+    button_oracle_emit_fn emit;
+    void *emit_ctx;
+#if !BUTTON_FEATURE_DISPATCH
+    /* Events are polled from the live state page */
+    _Alignas(button_monitor_page_t) uint8_t monitor[BUTTON_MONITOR_PAGE_SIZE(BUTTON_ORACLE_MAX_BUTTONS)];
+#endif
+} oracle_bank_t;
+
+static const bool *bank_levels;
+static uint32_t bank_tick;
+static oracle_bank_t bank_instance;
+
+static bool bank_read_pin(uint32_t pin_mask);
+static uint32_t bank_get_tick(void);
+#if BUTTON_FEATURE_DISPATCH
+static void bank_callback(uint16_t index, button_event_t event, void* context);
+#endif
+static bool bank_reset(void* self, uint16_t count, const button_stage_config_t* stages, uint8_t stage_count,
+                       uint32_t tick, button_oracle_emit_fn emit, void* emit_ctx);
+static void bank_step(void* self, const bool* pressed, uint32_t tick);
+
+static const button_oracle_engine_t bank_engine = {
+    .name = "bank",
+    .self = &bank_instance,
+    .reset = bank_reset,
+    .step = bank_step,
+};
+
+const button_oracle_engine_t* ButtonOracle_BankEngine(void) {
+    return &bank_engine;
+}
+
+static bool bank_read_pin(uint32_t pin_mask) {
+    return bank_levels[pin_mask];
+}
+
+static uint32_t bank_get_tick(void) {
+    return bank_tick;
+}
+
+#if BUTTON_FEATURE_DISPATCH
+static void bank_callback(uint16_t index, button_event_t event, void* context) {
+    oracle_bank_t *ob = (oracle_bank_t*)context;
+    ob->emit(index, event, ob->emit_ctx);
+}
+#endif
+
+static bool bank_reset(void* self, uint16_t count, const button_stage_config_t* stages, uint8_t stage_count,
+                       uint32_t tick, button_oracle_emit_fn emit, void* emit_ctx) {
+    oracle_bank_t *ob = (oracle_bank_t*)self;
+    if (count > BUTTON_ORACLE_MAX_BUTTONS) return false;
+
+    ob->profile = (button_profile_t)BUTTON_PROFILE_DEFAULT(stages, stage_count);
+    ob->emit = emit;
+    ob->emit_ctx = emit_ctx;
+    for (uint16_t i = 0; i < count; i++) {
+        ob->entries[i] = (button_bank_entry_t){ .gpio_num = i, .active_level = BUTTON_ACTIVE_HIGH, .profile = 0 };
+    }
+
+    bank_tick = tick;
+    if (Button_BankInit(&ob->bank, ob->entries, ob->states, count, &ob->profile, 1, bank_read_pin, bank_get_tick) != BUTTON_OK) return false;
+#if BUTTON_FEATURE_DISPATCH
+    return Button_BankRegisterHandler(&ob->bank, bank_callback, ob) == BUTTON_OK;
+#else
+    return Button_BankConfigMonitor(&ob->bank, (button_monitor_page_t*)ob->monitor) == BUTTON_OK;
+#endif
+}
+
+static void bank_step(void* self, const bool* pressed, uint32_t tick) {
+    oracle_bank_t *ob = (oracle_bank_t*)self;
+    bank_levels = pressed;
+    bank_tick = tick;
+    Button_BankUpdate(&ob->bank);
+
+#if !BUTTON_FEATURE_DISPATCH
+    /* Same thread as the sweep, so slots are read without the page seqlock.
+       A slot whose event is stamped with this sweep's tick dispatched during it */
+    const button_monitor_page_t *page = (const button_monitor_page_t*)ob->monitor;
+    for (uint16_t i = 0; i < ob->bank.count; i++) {
+        uint32_t status = atomic_load_explicit(&page->slots[i].status, memory_order_relaxed);
+        uint32_t event_tick = atomic_load_explicit(&page->slots[i].last_event_tick, memory_order_relaxed);
+        button_event_t event = BUTTON_MONITOR_EVENT(status);
+        if (event != BUTTON_EVENT_NONE && event_tick == tick) ob->emit(i, event, ob->emit_ctx);
+    }
+#endif
+}
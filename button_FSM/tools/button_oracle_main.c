@@ -0,0 +1,159 @@
+/**
+ * @file    button_oracle_main.c
+ * @author  datngyB
+ * @brief   Runs every candidate engine against the reference FSM.
+ * @version 0.1.0
+ * @date    2026-10-18
+ * * @copyright Copyright (c) 2026
+ *
+ * Usage: button_oracle [-n runs] [-s seed] [-w] [trace-file ...]
+ *
+ * Without trace files, runs randomized traces: biased towards the FSM
+ * boundaries, or with -w realistic panel workloads (button_workload.h). A recorded trace file holds one
+ * level change per line: "<tick> <button> <0|1>", ticks ascending; '#' starts a
+ * comment. Optional header lines "stage <threshold> <event> [hold]" add stages
+ * (hold: HOLD interval from that stage on, 0 inherits, 4294967295 stops) and
+ * "duration <ticks>" sets the replay length.
+ *
+ * Build: cc -O2 -Iinclude -Itools button_static.c button_bank.c button_latency.c tools/button_oracle*.c tools/button_workload.c -lm
+ * Exit status is non-zero on the first divergence.
+ */
+
+#include    <stdbool.h>
+#include    <stdint.h>
+#include    <stdio.h>
+#include    <stdlib.h>
+#include    <string.h>
+#include    "button_oracle.h"
+
+#define ORACLE_RANDOM_DURATION      60000u
+#define ORACLE_MAX_EDGES            (1u << 18)
+
+typedef const button_oracle_engine_t* (*engine_getter_fn)(void);
+
+/* Every optimized engine is registered here */
+static const engine_getter_fn candidates[] = {
+    ButtonOracle_ReferenceEngine,
+    ButtonOracle_BankEngine,
+};
+
+static button_oracle_edge_t edge_buf[ORACLE_MAX_EDGES];
+
+static bool run_one(const button_oracle_engine_t* engine, const button_oracle_trace_t* trace, const char* label);
+static bool load_trace(const char* path, button_oracle_trace_t* trace, button_oracle_trace_buf_t* buf);
+
+static bool run_one(const button_oracle_engine_t* engine, const button_oracle_trace_t* trace, const char* label) {
+    button_oracle_report_t report;
+    button_error_t err = ButtonOracle_Run(engine, trace, &report);
+
+    if (err != BUTTON_OK) {
+        printf("FAIL %-18s %s: harness error %d\n", engine->name, label, (int)err);
+        return false;
+    }
+    if (!report.match) {
+        printf("FAIL %-18s %s: tick +%lu (abs %lu) #%lu expected btn %u ev %d, got btn %u ev %d\n",
+               engine->name, label, (unsigned long)report.mismatch_tick,
+               (unsigned long)(trace->start_tick + report.mismatch_tick), (unsigned long)report.mismatch_position,
+               (unsigned)report.expected_index, (int)report.expected_event,
+               (unsigned)report.actual_index, (int)report.actual_event);
+        return false;
+    }
+    printf("ok   %-18s %s: %lu ticks, %llu events\n", engine->name, label,
+           (unsigned long)report.ticks_compared, (unsigned long long)report.events_compared);
+    return true;
+}
+
+static bool load_trace(const char* path, button_oracle_trace_t* trace, button_oracle_trace_buf_t* buf) {
+    FILE *f = fopen(path, "r");
+    char line[128];
+    uint32_t n = 0;
+    uint32_t last_tick = 0;
+    uint32_t duration = 0;
+    uint16_t max_index = 0;
+    uint8_t stage_count = 0;
+
+    if (!f) return false;
+    while (fgets(line, sizeof(line), f)) {
+        unsigned long a, b, c = 0;
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') continue;
+        if (sscanf(line, "stage %lu %lu %lu", &a, &b, &c) >= 2) {
+            if (stage_count >= BUTTON_ORACLE_MAX_STAGES || b >= BUTTON_EVENT_MAX) break;
+            buf->stages[stage_count].threshold = (uint32_t)a;
+            buf->stages[stage_count].event = (button_event_t)b;
+            buf->stages[stage_count].hold_ticks = (uint32_t)c;
+            stage_count++;
+        } else if (sscanf(line, "duration %lu", &a) == 1) {
+            duration = (uint32_t)a;
+        } else if (sscanf(line, "%lu %lu %lu", &a, &b, &c) == 3) {
+            if (n >= buf->capacity || b >= BUTTON_ORACLE_MAX_BUTTONS || a < last_tick) break;
+            buf->edges[n++] = (button_oracle_edge_t){ .tick = (uint32_t)a, .index = (uint16_t)b, .pressed = (c != 0) };
+            last_tick = (uint32_t)a;
+            if (b > max_index) max_index = (uint16_t)b;
+        } else {
+            break;
+        }
+    }
+    bool complete = feof(f) != 0;
+    fclose(f);
+    if (!complete) return false;
+
+    *trace = (button_oracle_trace_t){
+        .edges = buf->edges,
+        .edge_count = n,
+        .button_count = (uint16_t)(max_index + 1u),
+        .start_tick = 0,
+        .duration = duration ? duration : last_tick + 4u * BUTTON_LONG_PRESS_TICKS,
+        .stages = (stage_count > 0) ? buf->stages : NULL,
+        .stage_count = stage_count,
+    };
+    return true;
+}
+
+int main(int argc, char** argv) {
+    uint32_t runs = 50;
+    uint32_t seed = 0x1234567u;
+    bool all_ok = true;
+    bool any_file = false;
+    bool workload = false;
+    button_oracle_trace_buf_t buf = { .edges = edge_buf, .capacity = ORACLE_MAX_EDGES };
+    button_oracle_trace_t trace;
+    char label[64];
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            runs = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-w") == 0) {
+            workload = true;
+        } else {
+            any_file = true;
+            if (!load_trace(argv[i], &trace, &buf)) {
+                printf("FAIL cannot parse trace %s\n", argv[i]);
+                all_ok = false;
+                continue;
+            }
+            for (size_t c = 0; c < sizeof(candidates) / sizeof(candidates[0]); c++) {
+                all_ok &= run_one(candidates[c](), &trace, argv[i]);
+            }
+        }
+    }
+
+    if (!any_file) {
+        for (uint32_t r = 0; r < runs; r++) {
+            uint32_t run_seed = seed + r * 0x9E3779B9u;
+            uint16_t count = (uint16_t)(1u + (run_seed >> 8) % BUTTON_ORACLE_MAX_BUTTONS);
+            button_error_t err = workload ? ButtonOracle_WorkloadTrace(&trace, &buf, run_seed, count, ORACLE_RANDOM_DURATION)
+                                          : ButtonOracle_RandomTrace(&trace, &buf, run_seed, count, ORACLE_RANDOM_DURATION);
+            if (err != BUTTON_OK) {
+                printf("FAIL cannot generate trace for seed 0x%08lx\n", (unsigned long)run_seed);
+                return 1;
+            }
+            snprintf(label, sizeof(label), "%s 0x%08lx x%u", workload ? "load" : "seed", (unsigned long)run_seed, (unsigned)count);
+            for (size_t c = 0; c < sizeof(candidates) / sizeof(candidates[0]); c++) {
+                all_ok &= run_one(candidates[c](), &trace, label);
+            }
+        }
+    }
+    return all_ok ? 0 : 1;
+}
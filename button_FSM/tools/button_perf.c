@@ -0,0 +1,138 @@
+#if defined(__linux__)
+#define     _GNU_SOURCE
+#endif
+#include    <stdbool.h>
+#include    <stdint.h>
+#include    <string.h>
+#include    "button_perf.h"
+
+#if defined(__linux__)
+#include    <unistd.h>
+#include    <sys/ioctl.h>
+#include    <sys/syscall.h>
+#include    <linux/perf_event.h>
+#endif
+
+static const char *const counter_names[BUTTON_PERF_MAX] = { "cycles", "instructions", "branch-misses", "cache-misses" };
+
+#if defined(__linux__)
+
+static const uint64_t counter_configs[BUTTON_PERF_MAX] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_BRANCH_MISSES,
+    PERF_COUNT_HW_CACHE_MISSES,
+};
+
+static int open_counter(uint64_t config);
+
+bool ButtonPerf_Open(button_perf_t* perf) {
+    bool any = false;
+
+    for (int c = 0; c < BUTTON_PERF_MAX; c++) {
+        perf->fds[c] = open_counter(counter_configs[c]);
+        if (perf->fds[c] >= 0) any = true;
+    }
+    return any;
+}
+
+void ButtonPerf_Start(button_perf_t* perf) {
+    ButtonPerf_Reset(perf);
+    ButtonPerf_Resume(perf);
+}
+
+void ButtonPerf_Reset(button_perf_t* perf) {
+    for (int c = 0; c < BUTTON_PERF_MAX; c++) {
+        if (perf->fds[c] < 0) continue;
+        ioctl(perf->fds[c], PERF_EVENT_IOC_DISABLE, 0);
+        ioctl(perf->fds[c], PERF_EVENT_IOC_RESET, 0);
+    }
+}
+
+void ButtonPerf_Resume(button_perf_t* perf) {
+    for (int c = 0; c < BUTTON_PERF_MAX; c++) {
+        if (perf->fds[c] >= 0) ioctl(perf->fds[c], PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+void ButtonPerf_Pause(button_perf_t* perf) {
+    for (int c = 0; c < BUTTON_PERF_MAX; c++) {
+        if (perf->fds[c] >= 0) ioctl(perf->fds[c], PERF_EVENT_IOC_DISABLE, 0);
+    }
+}
+
+void ButtonPerf_Stop(button_perf_t* perf, button_perf_sample_t* sample) {
+    /* Disable everything first so the reads below are not counted */
+    ButtonPerf_Pause(perf);
+
+    for (int c = 0; c < BUTTON_PERF_MAX; c++) {
+        uint64_t data[3];   /* value, time enabled, time running */
+        sample->value[c] = 0;
+        sample->valid[c] = false;
+        if (perf->fds[c] < 0 || read(perf->fds[c], data, sizeof(data)) != (ssize_t)sizeof(data) || data[2] == 0) continue;
+
+        sample->value[c] = (data[2] < data[1]) ? (uint64_t)((double)data[0] * (double)data[1] / (double)data[2]) : data[0];
+        sample->valid[c] = true;
+    }
+}
+
+void ButtonPerf_Close(button_perf_t* perf) {
+    for (int c = 0; c < BUTTON_PERF_MAX; c++) {
+        if (perf->fds[c] >= 0) close(perf->fds[c]);
+        perf->fds[c] = -1;
+    }
+}
+
+static int open_counter(uint64_t config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+#else
+
+bool ButtonPerf_Open(button_perf_t* perf) {
+    for (int c = 0; c < BUTTON_PERF_MAX; c++) {
+        perf->fds[c] = -1;
+    }
+    return false;
+}
+
+void ButtonPerf_Start(button_perf_t* perf) {
+    (void)perf;
+}
+
+void ButtonPerf_Reset(button_perf_t* perf) {
+    (void)perf;
+}
+
+void ButtonPerf_Resume(button_perf_t* perf) {
+    (void)perf;
+}
+
+void ButtonPerf_Pause(button_perf_t* perf) {
+    (void)perf;
+}
+
+void ButtonPerf_Stop(button_perf_t* perf, button_perf_sample_t* sample) {
+    (void)perf;
+    memset(sample, 0, sizeof(*sample));
+}
+
+void ButtonPerf_Close(button_perf_t* perf) {
+    (void)perf;
+}
+
+#endif
+
+const char* ButtonPerf_Name(button_perf_counter_t counter) {
+    return (counter < BUTTON_PERF_MAX) ? counter_names[counter] : "?";
+}
@@ -0,0 +1,52 @@
+/**
+ * @file    button_perf.h
+ * @author  datngyB
+ * @brief   Hardware performance counters for the benchmark tools (Linux perf_event_open).
+ * @version 0.1.0
+ * @date    2026-10-18
+ * * @copyright Copyright (c) 2026
+ *
+ * Counts user-space cycles, instructions, branch misses and cache misses of
+ * the calling thread between ButtonPerf_Start and ButtonPerf_Stop. To count
+ * only some sections of a loop, ButtonPerf_Reset once and bracket each
+ * section with ButtonPerf_Resume / ButtonPerf_Pause; the few user-space
+ * instructions of the ioctl stubs are counted with each section. Counters
+ * the host refuses (no PMU in a VM, perf_event_paranoid, non-Linux build)
+ * are reported as unavailable and the benchmark still runs. When the kernel
+ * multiplexes counters, values are scaled by enabled/running time.
+ */
+
+#ifndef BUTTON_PERF_H
+#define BUTTON_PERF_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+    BUTTON_PERF_CYCLES = 0,
+    BUTTON_PERF_INSTRUCTIONS,
+    BUTTON_PERF_BRANCH_MISSES,
+    BUTTON_PERF_CACHE_MISSES,
+    BUTTON_PERF_MAX
+} button_perf_counter_t;
+
+typedef struct {
+    int fds[BUTTON_PERF_MAX];   /**< -1 when the counter could not be opened */
+} button_perf_t;
+
+typedef struct {
+    uint64_t value[BUTTON_PERF_MAX];
+    bool valid[BUTTON_PERF_MAX];
+} button_perf_sample_t;
+
+// API
+bool ButtonPerf_Open(button_perf_t* perf);     // true when at least one counter is available
+void ButtonPerf_Start(button_perf_t* perf);    // Reset and Resume
+void ButtonPerf_Reset(button_perf_t* perf);    // Zero the counters, leaving them stopped
+void ButtonPerf_Resume(button_perf_t* perf);
+void ButtonPerf_Pause(button_perf_t* perf);
+void ButtonPerf_Stop(button_perf_t* perf, button_perf_sample_t* sample);
+void ButtonPerf_Close(button_perf_t* perf);
+const char* ButtonPerf_Name(button_perf_counter_t counter);
+
+#endif // BUTTON_PERF_H
@@ -0,0 +1,269 @@
+/**
+ * @file    button_record_check.c
+ * @author  datngyB
+ * @brief   Round-trip of packed 4-byte event records and their batches.
+ * @version 0.1.0
+ * @date    2026-10-18
+ * * @copyright Copyright (c) 2026
+ *
+ * Each run checks:
+ *   - the record word: every event with index and delta corners (0, 1, the
+ *     middle, BUTTON_RECORD_MAX_INDEX and BUTTON_RECORD_MAX_DELTA) and random
+ *     values packs and unpacks to the same fields, and no field spills into
+ *     its neighbours;
+ *   - the limits: index 4096 and BUTTON_EVENT_MAX are refused without writing
+ *     anything; a record BUTTON_RECORD_MAX_DELTA ticks after the batch base
+ *     stays in the batch, one tick more opens a new batch;
+ *   - a random log of events with short and long gaps, across the 32-bit tick
+ *     wrap, written through ButtonRecord_OnEvent and read back: same events
+ *     and ticks, one batch per base that fell out of range, every word used;
+ *   - a log too small for the events: the dropped count matches, and the
+ *     reader returns exactly the records that were kept. A reader over a log
+ *     cut inside its last batch stops before that batch.
+ *
+ * Usage: button_record_check [-n runs] [-s seed]
+ * Build: cc -O2 -Iinclude button_record.c tools/button_record_check.c
+ * Exit status is non-zero on the first mismatch.
+ */
+
+#include    <stdbool.h>
+#include    <stdint.h>
+#include    <stdio.h>
+#include    <stdlib.h>
+#include    <string.h>
+#include    "button_record.h"
+
+#define CHECK_RANDOM_WORDS          10000u  /* Random record words per run */
+#define CHECK_EVENTS                5000u
+#define CHECK_LOG_WORDS             (CHECK_EVENTS * 3u)     /* Room for a batch per event */
+#define CHECK_SMALL_WORDS           64u
+
+typedef struct {
+    uint16_t index;
+    button_event_t event;
+    uint32_t tick;
+} check_event_t;
+
+static check_event_t expected[CHECK_EVENTS];
+static uint32_t log_words[CHECK_LOG_WORDS];
+static uint32_t clock_tick;
+static uint32_t rng_state;
+
+static uint32_t check_rand(void);
+static uint32_t check_get_tick(void);
+static bool fields_match(uint32_t seed, uint16_t index, button_event_t event, uint32_t delta);
+static bool words_round_trip(uint32_t seed);
+static bool limits_hold(uint32_t seed);
+static uint32_t next_gap(void);
+static bool read_back(uint32_t seed, const uint32_t* words, uint32_t used, uint32_t count, const char* what);
+static bool log_round_trip(uint32_t seed, uint32_t* batches);
+static bool full_log_drops(uint32_t seed, uint32_t* dropped);
+static bool run_one(uint32_t seed);
+
+
+static uint32_t check_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static uint32_t check_get_tick(void) {
+    return clock_tick;
+}
+
+static bool fields_match(uint32_t seed, uint16_t index, button_event_t event, uint32_t delta) {
+    button_record_t rec = BUTTON_RECORD_PACK(index, event, delta);
+    if (BUTTON_RECORD_INDEX(rec) != index || BUTTON_RECORD_EVENT(rec) != event || BUTTON_RECORD_DELTA(rec) != delta) {
+        printf("FAIL seed 0x%08lx: index %u event %d delta %lu packed to 0x%08lx, unpacked index %u event %d delta %u\n",
+               (unsigned long)seed, (unsigned)index, (int)event, (unsigned long)delta, (unsigned long)rec,
+               (unsigned)BUTTON_RECORD_INDEX(rec), (int)BUTTON_RECORD_EVENT(rec), (unsigned)BUTTON_RECORD_DELTA(rec));
+        return false;
+    }
+    return true;
+}
+
+static bool words_round_trip(uint32_t seed) {
+    static const uint16_t indexes[] = { 0u, 1u, 0x07FFu, 0x0800u, BUTTON_RECORD_MAX_INDEX - 1u, BUTTON_RECORD_MAX_INDEX };
+    static const uint32_t deltas[] = { 0u, 1u, 0x7FFFu, 0x8000u, BUTTON_RECORD_MAX_DELTA - 1u, BUTTON_RECORD_MAX_DELTA };
+
+    for (button_event_t e = BUTTON_EVENT_NONE; e < BUTTON_EVENT_MAX; e++) {
+        for (size_t i = 0; i < sizeof(indexes) / sizeof(indexes[0]); i++) {
+            for (size_t d = 0; d < sizeof(deltas) / sizeof(deltas[0]); d++) {
+                if (!fields_match(seed, indexes[i], e, deltas[d])) return false;
+            }
+        }
+    }
+    for (uint32_t n = 0; n < CHECK_RANDOM_WORDS; n++) {
+        uint16_t index = (uint16_t)(check_rand() % (BUTTON_RECORD_MAX_INDEX + 1u));
+        button_event_t event = (button_event_t)(check_rand() % BUTTON_EVENT_MAX);
+        uint32_t delta = check_rand() % (BUTTON_RECORD_MAX_DELTA + 1u);
+        if (!fields_match(seed, index, event, delta)) return false;
+    }
+    return true;
+}
+
+static bool limits_hold(uint32_t seed) {
+    button_record_log_t log;
+    uint32_t base = check_rand();
+
+    ButtonRecord_LogInit(&log, log_words, CHECK_LOG_WORDS, NULL);
+    if (ButtonRecord_Append(&log, BUTTON_RECORD_MAX_INDEX + 1u, BUTTON_EVENT_PRESSED, base) != BUTTON_ERR_INVALID_ARG ||
+        ButtonRecord_Append(&log, 0, BUTTON_EVENT_MAX, base) != BUTTON_ERR_INVALID_ARG || log.used != 0) {
+        printf("FAIL seed 0x%08lx: out-of-range index or event accepted (%lu words written)\n",
+               (unsigned long)seed, (unsigned long)log.used);
+        return false;
+    }
+
+    /* Header + 2 records, then a second header + 1 record */
+    ButtonRecord_Append(&log, BUTTON_RECORD_MAX_INDEX, BUTTON_EVENT_PRESSED, base);
+    ButtonRecord_Append(&log, BUTTON_RECORD_MAX_INDEX, BUTTON_EVENT_HOLD, base + BUTTON_RECORD_MAX_DELTA);
+    ButtonRecord_Append(&log, BUTTON_RECORD_MAX_INDEX, BUTTON_EVENT_RELEASED, base + BUTTON_RECORD_MAX_DELTA + 1u);
+    uint32_t layout[] = {
+        base, 2u,
+        BUTTON_RECORD_PACK(BUTTON_RECORD_MAX_INDEX, BUTTON_EVENT_PRESSED, 0u),
+        BUTTON_RECORD_PACK(BUTTON_RECORD_MAX_INDEX, BUTTON_EVENT_HOLD, BUTTON_RECORD_MAX_DELTA),
+        base + BUTTON_RECORD_MAX_DELTA + 1u, 1u,
+        BUTTON_RECORD_PACK(BUTTON_RECORD_MAX_INDEX, BUTTON_EVENT_RELEASED, 0u),
+    };
+    if (log.used != sizeof(layout) / sizeof(layout[0]) || memcmp(log_words, layout, sizeof(layout)) != 0) {
+        printf("FAIL seed 0x%08lx: records at delta 0, %lu and %lu from base %lu laid out in %lu words, expected %lu\n",
+               (unsigned long)seed, (unsigned long)BUTTON_RECORD_MAX_DELTA, (unsigned long)BUTTON_RECORD_MAX_DELTA + 1u,
+               (unsigned long)base, (unsigned long)log.used, (unsigned long)(sizeof(layout) / sizeof(layout[0])));
+        return false;
+    }
+    return true;
+}
+
+/* Mostly short gaps, some just around the delta limit, a few far past it */
+static uint32_t next_gap(void) {
+    uint32_t pick = check_rand() % 100u;
+    if (pick < 80u) return check_rand() % 200u;
+    if (pick < 95u) return BUTTON_RECORD_MAX_DELTA - 2u + check_rand() % 5u;
+    return check_rand() % 0x01000000u;
+}
+
+static bool read_back(uint32_t seed, const uint32_t* words, uint32_t used, uint32_t count, const char* what) {
+    button_record_reader_t rd;
+    uint16_t index;
+    button_event_t event;
+    uint32_t tick;
+    uint32_t n = 0;
+
+    ButtonRecord_ReaderInit(&rd, words, used);
+    while (ButtonRecord_Read(&rd, &index, &event, &tick)) {
+        if (n >= count || index != expected[n].index || event != expected[n].event || tick != expected[n].tick) {
+            printf("FAIL seed 0x%08lx: %s, record %lu read as button %u event %d tick %lu\n", (unsigned long)seed,
+                   what, (unsigned long)n, (unsigned)index, (int)event, (unsigned long)tick);
+            return false;
+        }
+        n++;
+    }
+    if (n != count) {
+        printf("FAIL seed 0x%08lx: %s, %lu records read, expected %lu\n", (unsigned long)seed, what,
+               (unsigned long)n, (unsigned long)count);
+        return false;
+    }
+    return true;
+}
+
+static bool log_round_trip(uint32_t seed, uint32_t* batches) {
+    button_record_log_t log;
+    uint32_t base = 0;
+
+    /* Starts within a few gaps of the wrap */
+    clock_tick = 0xFFFFFFFFu - check_rand() % 0x00100000u;
+    ButtonRecord_LogInit(&log, log_words, CHECK_LOG_WORDS, check_get_tick);
+    *batches = 0;
+    for (uint32_t n = 0; n < CHECK_EVENTS; n++) {
+        if (n > 0) clock_tick += next_gap();
+        if (n == 0 || clock_tick - base > BUTTON_RECORD_MAX_DELTA) {
+            base = clock_tick;
+            (*batches)++;
+        }
+        expected[n].index = (uint16_t)(check_rand() % (BUTTON_RECORD_MAX_INDEX + 1u));
+        expected[n].event = (button_event_t)(1u + check_rand() % (BUTTON_EVENT_MAX - 1u));
+        expected[n].tick = clock_tick;
+        ButtonRecord_OnEvent(expected[n].index, expected[n].event, &log);
+    }
+
+    uint32_t words = CHECK_EVENTS + *batches * BUTTON_RECORD_HEADER_WORDS;
+    if (log.used != words || log.dropped != 0) {
+        printf("FAIL seed 0x%08lx: %lu events in %lu words (%lu dropped), expected %lu batches in %lu words\n",
+               (unsigned long)seed, (unsigned long)CHECK_EVENTS, (unsigned long)log.used, (unsigned long)log.dropped,
+               (unsigned long)*batches, (unsigned long)words);
+        return false;
+    }
+    return read_back(seed, log_words, log.used, CHECK_EVENTS, "full log");
+}
+
+static bool full_log_drops(uint32_t seed, uint32_t* dropped) {
+    button_record_log_t log;
+    uint32_t kept = 0;
+    uint32_t last_kept = 0;     /* Records before the last batch */
+
+    clock_tick = check_rand();
+    ButtonRecord_LogInit(&log, log_words, CHECK_SMALL_WORDS, NULL);
+    for (uint32_t n = 0; n < CHECK_EVENTS / 10u; n++) {
+        clock_tick += next_gap();
+        check_event_t ev = {
+            .index = (uint16_t)(check_rand() % (BUTTON_RECORD_MAX_INDEX + 1u)),
+            .event = (button_event_t)(1u + check_rand() % (BUTTON_EVENT_MAX - 1u)),
+            .tick = clock_tick,
+        };
+        uint32_t batch = log.batch;
+        bool opened = log.open;
+        if (ButtonRecord_Append(&log, ev.index, ev.event, ev.tick) == BUTTON_OK) {
+            if (!opened || log.batch != batch) last_kept = kept;
+            expected[kept++] = ev;
+        }
+    }
+
+    *dropped = log.dropped;
+    if (log.used > CHECK_SMALL_WORDS || kept + log.dropped != CHECK_EVENTS / 10u || log.dropped == 0) {
+        printf("FAIL seed 0x%08lx: small log used %lu of %lu words, kept %lu, dropped %lu of %lu\n",
+               (unsigned long)seed, (unsigned long)log.used, (unsigned long)CHECK_SMALL_WORDS, (unsigned long)kept,
+               (unsigned long)log.dropped, (unsigned long)(CHECK_EVENTS / 10u));
+        return false;
+    }
+    if (!read_back(seed, log_words, log.used, kept, "small log")) return false;
+    /* One word short of the last batch: only the batches before it are read */
+    return read_back(seed, log_words, log.used - 1u, last_kept, "cut log");
+}
+
+static bool run_one(uint32_t seed) {
+    uint32_t batches = 0;
+    uint32_t dropped = 0;
+
+    rng_state = seed | 1u;
+    if (!words_round_trip(seed)) return false;
+    if (!limits_hold(seed)) return false;
+    if (!log_round_trip(seed, &batches)) return false;
+    if (!full_log_drops(seed, &dropped)) return false;
+
+    printf("ok   seed 0x%08lx: %lu events in %lu batches, %lu dropped by the small log\n", (unsigned long)seed,
+           (unsigned long)CHECK_EVENTS, (unsigned long)batches, (unsigned long)dropped);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    uint32_t runs = 4;
+    uint32_t seed = 0x1234567u;
+    bool all_ok = true;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            runs = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            printf("usage: %s [-n runs] [-s seed]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    for (uint32_t r = 0; r < runs && all_ok; r++) {
+        all_ok = run_one(seed + r * 0x9E3779B9u);
+    }
+    return all_ok ? 0 : 1;
+}
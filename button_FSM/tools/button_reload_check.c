@@ -0,0 +1,352 @@
+/**
+ * @file    button_reload_check.c
+ * @author  datngyB
+ * @brief   Profile, keymap and handler hot reload while another thread sweeps the bank.
+ * @version 0.1.0
+ * @date    2026-10-18
+ * * @copyright Copyright (c) 2026
+ *
+ * The main thread sweeps a bank as fast as it can, one tick per sweep, with
+ * every button pressed long enough to reach both stages of its profile and a
+ * few HOLDs. A writer thread cycles CHECK_TABLES profile tables through
+ * Button_BankPublishProfiles and CHECK_TABLES keymaps through
+ * Button_BankSetKeymap, and the bank handler through CHECK_TABLES contexts,
+ * either replacing it or unregistering it (Button_BankHandlerGrace). It
+ * poisons a retired table, keymap or context as soon as
+ * Button_BankGraceElapsed says its grace has elapsed:
+ *   - a poisoned profile has stage thresholds of 1 tick and stage events of
+ *     BUTTON_EVENT_POWER_ON_HELD, which this bank never reports otherwise;
+ *   - a poisoned keymap maps every event to CHECK_POISON_ACTION;
+ *   - a poisoned context holds CHECK_POISON_ACTION instead of
+ *     CHECK_CONTEXT_LIVE.
+ * A sweep that still uses one of them after its grace reports it, through
+ * Button_BankUpdateEx, the handlers or the action handler.
+ *
+ * On x86 the sweep_seq increment is a full barrier and the window cannot
+ * open; the check matters on weakly ordered CPUs and under
+ * -fsanitize=thread, which reports the poisoning writes as races with the
+ * sweep if a grace elapses early.
+ *
+ * Usage: button_reload_check [-n runs] [-s seed]
+ * Build: cc -O2 -pthread -Iinclude button_static.c button_bank.c button_latency.c tools/button_reload_check.c
+ * Exit status is non-zero on the first mismatch. Builds without stages check
+ * only keymaps and handlers, builds without dispatch only profiles; with
+ * neither, only -fsanitize=thread sees a table used after its grace.
+ */
+
+#include    <stdbool.h>
+#include    <stdint.h>
+#include    <stdio.h>
+#include    <stdlib.h>
+#include    <string.h>
+#include    <stdatomic.h>
+#include    <pthread.h>
+#include    <sched.h>
+#include    "button_bank.h"
+
+#define CHECK_BUTTONS               16u
+#define CHECK_SWEEPS                200000u
+#define CHECK_TABLES                4u      /* Profile tables and keymaps the writer cycles through */
+#define CHECK_PRESS_TICKS           10u     /* Long press at +3, stages at +5 and +7 */
+#define CHECK_RELEASE_TICKS         2u
+#define CHECK_YIELD_SWEEPS          64u
+#define CHECK_ACTION                1u
+#define CHECK_POISON_ACTION         0xDEADu
+#define CHECK_POISON_EVENT          BUTTON_EVENT_POWER_ON_HELD
+#define CHECK_CONTEXT_LIVE          0xC0DEu
+
+typedef enum {
+    CHECK_SLOT_FREE = 0,
+    CHECK_SLOT_LIVE,
+    CHECK_SLOT_RETIRED,     /* Published before the live one; poisoned once its grace elapses */
+} check_slot_t;
+
+typedef struct {
+    button_profile_t profile;
+    button_stage_config_t stages[2];
+    check_slot_t slot;
+    button_grace_t grace;
+} check_table_t;
+
+#if BUTTON_FEATURE_DISPATCH
+typedef struct {
+    button_keymap_t keymap;
+    button_action_t actions[CHECK_BUTTONS * BUTTON_EVENT_MAX];
+    check_slot_t slot;
+    button_grace_t grace;
+} check_keymap_t;
+
+typedef struct {
+    uint32_t magic;             /* CHECK_CONTEXT_LIVE while registered or retired */
+    check_slot_t slot;
+    button_grace_t grace;
+} check_context_t;
+#endif
+
+static check_table_t tables[CHECK_TABLES];
+#if BUTTON_FEATURE_DISPATCH
+static check_keymap_t keymaps[CHECK_TABLES];
+static check_context_t contexts[CHECK_TABLES];
+#endif
+static button_bank_entry_t entries[CHECK_BUTTONS];
+static button_bank_state_t states[CHECK_BUTTONS];
+static button_bank_t bank;
+static uint32_t phases[CHECK_BUTTONS];
+static uint32_t sweep_tick;
+
+/* Sweeper reports, writer counts; the writer runs until done is set */
+static atomic_bool done;
+static atomic_uint_fast32_t poisoned_uses;
+static uint32_t profile_swaps;
+static uint32_t keymap_swaps;
+static uint32_t handler_swaps;
+static uint32_t rng_state;
+
+static uint32_t check_rand(void);
+static bool check_read_pin(uint32_t gpio_num);
+static uint32_t check_get_tick(void);
+static void table_fill(check_table_t* table, bool poison);
+#if BUTTON_FEATURE_DISPATCH
+static void keymap_fill(check_keymap_t* keymap, bool poison);
+static void check_action(uint16_t index, button_action_t action, void* context);
+static void check_event(uint16_t index, button_event_t event, void* context);
+#if BUTTON_FEATURE_STAGES
+static void check_stage(uint16_t index, button_event_t event, uint8_t stage, uint32_t threshold, void* context);
+#endif
+static void handler_register(check_context_t* context);
+#endif
+static void* writer_main(void* arg);
+static bool run_one(uint32_t seed);
+
+
+static uint32_t check_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+/* Button i is pressed for CHECK_PRESS_TICKS, released for CHECK_RELEASE_TICKS, from its own phase */
+static bool check_read_pin(uint32_t gpio_num) {
+    return (sweep_tick + phases[gpio_num]) % (CHECK_PRESS_TICKS + CHECK_RELEASE_TICKS) < CHECK_PRESS_TICKS;
+}
+
+static uint32_t check_get_tick(void) {
+    return sweep_tick;
+}
+
+/* Writer side only: the table is not published, or its grace has elapsed */
+static void table_fill(check_table_t* table, bool poison) {
+    table->stages[0] = (button_stage_config_t){ poison ? 1u : 2u, poison ? CHECK_POISON_EVENT : BUTTON_EVENT_SUPER_LONG_PRESSED, 0 };
+    table->stages[1] = (button_stage_config_t){ poison ? 1u : 4u, poison ? CHECK_POISON_EVENT : BUTTON_EVENT_SUPER_LONG_PRESSED, 0 };
+    table->profile = (button_profile_t){ 1u, 2u, 1u, table->stages, BUTTON_FEATURE_STAGES ? 2u : 0u };
+}
+
+#if BUTTON_FEATURE_DISPATCH
+static void keymap_fill(check_keymap_t* keymap, bool poison) {
+    for (uint32_t a = 0; a < CHECK_BUTTONS * BUTTON_EVENT_MAX; a++) {
+        keymap->actions[a] = poison ? CHECK_POISON_ACTION : CHECK_ACTION;
+    }
+    keymap->keymap = (button_keymap_t){ keymap->actions, CHECK_BUTTONS };
+}
+
+static void check_action(uint16_t index, button_action_t action, void* context) {
+    (void)index;
+    (void)context;
+    if (action != CHECK_ACTION) atomic_fetch_add(&poisoned_uses, 1);
+}
+
+static void check_event(uint16_t index, button_event_t event, void* context) {
+    (void)index;
+    (void)event;
+    if (((const check_context_t*)context)->magic != CHECK_CONTEXT_LIVE) atomic_fetch_add(&poisoned_uses, 1);
+}
+
+#if BUTTON_FEATURE_STAGES
+static void check_stage(uint16_t index, button_event_t event, uint8_t stage, uint32_t threshold, void* context) {
+    (void)index;
+    if (event != BUTTON_EVENT_SUPER_LONG_PRESSED || threshold != 2u + 2u * stage) atomic_fetch_add(&poisoned_uses, 1);
+    if (((const check_context_t*)context)->magic != CHECK_CONTEXT_LIVE) atomic_fetch_add(&poisoned_uses, 1);
+}
+#endif
+
+static void handler_register(check_context_t* context) {
+    context->magic = CHECK_CONTEXT_LIVE;
+    context->slot = CHECK_SLOT_LIVE;
+#if BUTTON_FEATURE_STAGES
+    Button_BankRegisterHandlerEx(&bank, check_event, check_stage, context);
+#else
+    Button_BankRegisterHandler(&bank, check_event, context);
+#endif
+}
+#endif
+
+/*
+ * Publishes the next table, keymap and handler context whenever they are
+ * free, retiring the live ones, and poisons what it retired as soon as the
+ * grace allows. The handler is also unregistered now and then, which retires
+ * its context with nothing in its place.
+ */
+static void* writer_main(void* arg) {
+    uint32_t live = 0;
+#if BUTTON_FEATURE_DISPATCH
+    uint32_t live_map = 0;
+    uint32_t live_ctx = 0;      /* CHECK_TABLES while no handler is registered */
+    uint32_t next_ctx = 1;
+#endif
+    (void)arg;
+
+    while (!atomic_load(&done)) {
+        for (uint32_t t = 0; t < CHECK_TABLES; t++) {
+            if (tables[t].slot == CHECK_SLOT_RETIRED && Button_BankGraceElapsed(&bank, tables[t].grace)) {
+                table_fill(&tables[t], true);
+                tables[t].slot = CHECK_SLOT_FREE;
+            }
+        }
+        uint32_t next = (live + 1u) % CHECK_TABLES;
+        if (tables[next].slot == CHECK_SLOT_FREE) {
+            table_fill(&tables[next], false);
+            if (Button_BankPublishProfiles(&bank, &tables[next].profile, 1, &tables[live].grace) != BUTTON_OK) {
+                atomic_fetch_add(&poisoned_uses, 1);
+                break;
+            }
+            tables[live].slot = CHECK_SLOT_RETIRED;
+            tables[next].slot = CHECK_SLOT_LIVE;
+            live = next;
+            profile_swaps++;
+        }
+
+#if BUTTON_FEATURE_DISPATCH
+        for (uint32_t k = 0; k < CHECK_TABLES; k++) {
+            if (keymaps[k].slot == CHECK_SLOT_RETIRED && Button_BankGraceElapsed(&bank, keymaps[k].grace)) {
+                keymap_fill(&keymaps[k], true);
+                keymaps[k].slot = CHECK_SLOT_FREE;
+            }
+        }
+        next = (live_map + 1u) % CHECK_TABLES;
+        if (keymaps[next].slot == CHECK_SLOT_FREE) {
+            keymap_fill(&keymaps[next], false);
+            Button_BankSetKeymap(&bank, &keymaps[next].keymap, &keymaps[live_map].grace);
+            keymaps[live_map].slot = CHECK_SLOT_RETIRED;
+            keymaps[next].slot = CHECK_SLOT_LIVE;
+            live_map = next;
+            keymap_swaps++;
+        }
+
+        for (uint32_t c = 0; c < CHECK_TABLES; c++) {
+            if (contexts[c].slot == CHECK_SLOT_RETIRED && Button_BankGraceElapsed(&bank, contexts[c].grace)) {
+                contexts[c].magic = CHECK_POISON_ACTION;
+                contexts[c].slot = CHECK_SLOT_FREE;
+            }
+        }
+        bool unregister = (live_ctx < CHECK_TABLES) && (check_rand() % 3u == 0);
+        if (unregister || contexts[next_ctx].slot == CHECK_SLOT_FREE) {
+            if (unregister) {
+                Button_BankUnregisterHandler(&bank);
+            } else {
+                handler_register(&contexts[next_ctx]);
+            }
+            if (live_ctx < CHECK_TABLES) {
+                Button_BankHandlerGrace(&bank, &contexts[live_ctx].grace);
+                contexts[live_ctx].slot = CHECK_SLOT_RETIRED;
+            }
+            if (unregister) {
+                live_ctx = CHECK_TABLES;
+            } else {
+                live_ctx = next_ctx;
+                next_ctx = (next_ctx + 1u) % CHECK_TABLES;
+            }
+            handler_swaps++;
+        }
+#endif
+        if (check_rand() % 4u == 0) sched_yield();
+    }
+    return NULL;
+}
+
+static bool run_one(uint32_t seed) {
+    pthread_t writer;
+
+    rng_state = seed | 1u;
+    memset(entries, 0, sizeof(entries));
+    for (uint16_t i = 0; i < CHECK_BUTTONS; i++) {
+        entries[i].gpio_num = i;
+        entries[i].active_level = BUTTON_ACTIVE_HIGH;
+        phases[i] = check_rand() % (CHECK_PRESS_TICKS + CHECK_RELEASE_TICKS);
+    }
+    for (uint32_t t = 0; t < CHECK_TABLES; t++) {
+        table_fill(&tables[t], t != 0);
+        tables[t].slot = (t == 0) ? CHECK_SLOT_LIVE : CHECK_SLOT_FREE;
+    }
+    sweep_tick = 0;
+    profile_swaps = 0;
+    keymap_swaps = 0;
+    handler_swaps = 0;
+    atomic_store(&done, false);
+    atomic_store(&poisoned_uses, 0);
+
+    if (Button_BankInit(&bank, entries, states, CHECK_BUTTONS, &tables[0].profile, 1, check_read_pin, check_get_tick) != BUTTON_OK) {
+        printf("FAIL seed 0x%08lx: init\n", (unsigned long)seed);
+        return false;
+    }
+#if BUTTON_FEATURE_DISPATCH
+    for (uint32_t k = 0; k < CHECK_TABLES; k++) {
+        keymap_fill(&keymaps[k], k != 0);
+        keymaps[k].slot = (k == 0) ? CHECK_SLOT_LIVE : CHECK_SLOT_FREE;
+    }
+    Button_BankConfigActions(&bank, check_action, NULL);
+    Button_BankSetKeymap(&bank, &keymaps[0].keymap, NULL);
+    for (uint32_t c = 1; c < CHECK_TABLES; c++) {
+        contexts[c] = (check_context_t){ CHECK_POISON_ACTION, CHECK_SLOT_FREE, 0 };
+    }
+    handler_register(&contexts[0]);
+#endif
+
+    if (pthread_create(&writer, NULL, writer_main, NULL) != 0) {
+        printf("FAIL seed 0x%08lx: thread\n", (unsigned long)seed);
+        return false;
+    }
+
+    uint32_t sweep = 0;
+    for (; sweep < CHECK_SWEEPS && atomic_load(&poisoned_uses) == 0; sweep++) {
+        button_event_mask_t events;
+        sweep_tick = sweep;
+        Button_BankUpdateEx(&bank, &events, NULL);
+        if (events & BUTTON_EVENT_BIT(CHECK_POISON_EVENT)) atomic_fetch_add(&poisoned_uses, 1);
+        if (sweep % CHECK_YIELD_SWEEPS == 0) sched_yield();    /* Lets the writer in on a single CPU */
+    }
+    atomic_store(&done, true);
+    pthread_join(writer, NULL);
+
+    uint32_t uses = (uint32_t)atomic_load(&poisoned_uses);
+    if (uses != 0) {
+        printf("FAIL seed 0x%08lx: sweep %lu used a table, keymap or handler after its grace (%lu times)\n", (unsigned long)seed,
+               (unsigned long)sweep, (unsigned long)uses);
+        return false;
+    }
+    printf("ok   seed 0x%08lx: %lu sweeps, %lu profile swaps, %lu keymap swaps, %lu handler changes\n", (unsigned long)seed,
+           (unsigned long)sweep, (unsigned long)profile_swaps, (unsigned long)keymap_swaps, (unsigned long)handler_swaps);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    uint32_t runs = 4;
+    uint32_t seed = 0x1234567u;
+    bool all_ok = true;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            runs = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            printf("usage: %s [-n runs] [-s seed]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    for (uint32_t r = 0; r < runs && all_ok; r++) {
+        all_ok = run_one(seed + r * 0x9E3779B9u);
+    }
+    return all_ok ? 0 : 1;
+}
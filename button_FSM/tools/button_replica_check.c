@@ -0,0 +1,373 @@
+/**
+ * @file    button_replica_check.c
+ * @author  datngyB
+ * @brief   Round trip of bank state through button_replica over real file descriptors.
+ * @version 0.1.0
+ * @date    2026-10-18
+ * * @copyright Copyright (c) 2026
+ *
+ * A primary bank is swept over a panel workload (button_workload.h) and its
+ * frames are carried to a standby bank, alternately over a pipe (byte stream:
+ * header first, then ButtonReplica_FrameLength) and a datagram socket pair.
+ * The standby runs on its own clock, offset from the primary's. After every
+ * sweep the check compares what the FSM reads of each button: state, profile,
+ * age of the last change and, in STATE_LONG_PRESSED, press start and HOLD
+ * ages, stage latches and HOLD stage.
+ *
+ * Along the way it also:
+ *   - uses a small frame capacity on some runs, so sweeps span MORE frames;
+ *   - requests a snapshot mid-run (ButtonReplica_Resync);
+ *   - re-applies the current or the previous frame at random, which must be
+ *     dropped as stale without touching any state;
+ *   - hands over at a random tick: from then on both banks are swept with the
+ *     same levels and must report the same events (Button_BankUpdateEx, and
+ *     the handler logs when BUTTON_FEATURE_DISPATCH is set) and state.
+ *
+ * Usage: button_replica_check [-n runs] [-s seed]
+ * Build: cc -O2 -Iinclude -Itools button_static.c button_bank.c button_latency.c button_replica.c tools/button_replica_check.c tools/button_workload.c -lm
+ * Exit status is non-zero on the first mismatch.
+ */
+
+#define     _GNU_SOURCE
+#include    <stdbool.h>
+#include    <stdint.h>
+#include    <stdio.h>
+#include    <stdlib.h>
+#include    <string.h>
+#include    <fcntl.h>
+#include    <unistd.h>
+#include    <sys/socket.h>
+#include    "button_bank.h"
+#include    "button_replica.h"
+#include    "button_workload.h"
+
+#define CHECK_BUTTONS               40u     /* Two mask words */
+#define CHECK_DURATION              60000u
+#define CHECK_SCAN_TICKS            5u
+#define CHECK_SMALL_FRAME           (BUTTON_REPLICA_MIN_FRAME + 16u)
+#define CHECK_MAX_FRAME             1024u
+#define CHECK_MAX_EVENTS            64u
+
+typedef enum {
+    CHECK_LINK_PIPE = 0,
+    CHECK_LINK_DGRAM,
+    CHECK_LINK_MAX
+} check_link_t;
+
+/* Frames pass through the kernel: fds[1] is written by the primary, fds[0] read by the standby */
+typedef struct {
+    check_link_t kind;
+    int fds[2];
+} check_channel_t;
+
+/* Events one bank dispatched during the current sweep */
+typedef struct {
+    uint16_t index[CHECK_MAX_EVENTS];
+    button_event_t event[CHECK_MAX_EVENTS];
+    uint32_t count;
+} check_log_t;
+
+static const button_stage_config_t check_stages[] = {
+    { 1500u, BUTTON_EVENT_SUPER_LONG_PRESSED, 100u },
+    { 4000u, BUTTON_EVENT_SUPER_LONG_PRESSED, BUTTON_HOLD_OFF },
+};
+
+/* Builds without stage support run the default profile without stages */
+#define CHECK_STAGE_COUNT   (BUTTON_FEATURE_STAGES ? 2u : 0u)
+
+static const button_profile_t check_profiles[] = {
+    BUTTON_PROFILE_DEFAULT(check_stages, CHECK_STAGE_COUNT),
+    { 30u, 700u, 150u, NULL, 0 },
+};
+
+static button_bank_entry_t entries[CHECK_BUTTONS];
+static button_bank_state_t primary_states[CHECK_BUTTONS];
+static button_bank_state_t standby_states[CHECK_BUTTONS];
+static button_bank_mask_t dirty[BUTTON_BANK_MASK_WORDS(CHECK_BUTTONS)];
+static button_bank_t primary;
+static button_bank_t standby;
+#if BUTTON_FEATURE_DISPATCH
+static check_log_t primary_log;
+static check_log_t standby_log;
+#endif
+
+/* Both banks read the same panel; the standby clock runs ahead by clock_offset */
+static bool levels[CHECK_BUTTONS];
+static uint32_t primary_tick;
+static uint32_t clock_offset;
+static uint32_t rng_state;
+
+static bool check_read_pin(uint32_t gpio_num);
+static uint32_t check_primary_tick(void);
+static uint32_t check_standby_tick(void);
+#if BUTTON_FEATURE_DISPATCH
+static void check_record(uint16_t index, button_event_t event, void* context);
+#endif
+static uint32_t check_rand(void);
+static bool channel_open(check_channel_t* ch, check_link_t kind);
+static void channel_close(check_channel_t* ch);
+static bool channel_send(check_channel_t* ch, const uint8_t* frame, size_t len);
+static bool channel_receive(check_channel_t* ch, uint8_t* frame, size_t* len);
+static bool read_all(int fd, uint8_t* p, size_t len);
+static bool compare_banks(uint32_t* index);
+static bool run_one(uint32_t seed);
+
+
+static bool check_read_pin(uint32_t gpio_num) {
+    return levels[gpio_num];
+}
+
+static uint32_t check_primary_tick(void) {
+    return primary_tick;
+}
+
+static uint32_t check_standby_tick(void) {
+    return primary_tick + clock_offset;
+}
+
+#if BUTTON_FEATURE_DISPATCH
+static void check_record(uint16_t index, button_event_t event, void* context) {
+    check_log_t *log = (check_log_t*)context;
+    if (log->count < CHECK_MAX_EVENTS) {
+        log->index[log->count] = index;
+        log->event[log->count] = event;
+    }
+    log->count++;
+}
+#endif
+
+static uint32_t check_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static bool channel_open(check_channel_t* ch, check_link_t kind) {
+    ch->kind = kind;
+    if (kind == CHECK_LINK_PIPE) return pipe2(ch->fds, O_CLOEXEC) == 0;
+    return socketpair(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0, ch->fds) == 0;
+}
+
+static void channel_close(check_channel_t* ch) {
+    close(ch->fds[0]);
+    close(ch->fds[1]);
+}
+
+/* Frames are far below the pipe and socket buffers, so one blocking write never waits */
+static bool channel_send(check_channel_t* ch, const uint8_t* frame, size_t len) {
+    return write(ch->fds[1], frame, len) == (ssize_t)len;
+}
+
+static bool channel_receive(check_channel_t* ch, uint8_t* frame, size_t* len) {
+    if (ch->kind == CHECK_LINK_DGRAM) {
+        ssize_t n = recv(ch->fds[0], frame, CHECK_MAX_FRAME, 0);
+        if (n < (ssize_t)BUTTON_REPLICA_HEADER_SIZE) return false;
+        *len = (size_t)n;
+        return true;
+    }
+
+    if (!read_all(ch->fds[0], frame, BUTTON_REPLICA_HEADER_SIZE)) return false;
+    if (ButtonReplica_FrameLength(frame, len) != BUTTON_OK || *len > CHECK_MAX_FRAME) return false;
+    return read_all(ch->fds[0], &frame[BUTTON_REPLICA_HEADER_SIZE], *len - BUTTON_REPLICA_HEADER_SIZE);
+}
+
+static bool read_all(int fd, uint8_t* p, size_t len) {
+    while (len > 0) {
+        ssize_t n = read(fd, p, len);
+        if (n <= 0) return false;
+        p += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+/* Fields the FSM reads, timestamps compared as ages on each bank's own clock */
+static bool compare_banks(uint32_t* index) {
+    uint32_t p_now = check_primary_tick();
+    uint32_t s_now = check_standby_tick();
+
+    for (uint32_t i = 0; i < CHECK_BUTTONS; i++) {
+        const button_bank_state_t *p = &primary_states[i];
+        const button_bank_state_t *s = &standby_states[i];
+        *index = i;
+        if (p->state != s->state) return false;
+        if (atomic_load(&p->profile) != atomic_load(&s->profile)) return false;
+        if (p_now - p->last_change_tick != s_now - s->last_change_tick) return false;
+        if (p->state != STATE_LONG_PRESSED) continue;
+        if (p_now - p->press_start_tick != s_now - s->press_start_tick) return false;
+        if (p_now - p->last_hold_tick != s_now - s->last_hold_tick) return false;
+        if (p->latches != s->latches || p->hold_stage != s->hold_stage) return false;
+    }
+    return true;
+}
+
+static bool run_one(uint32_t seed) {
+    button_workload_config_t config;
+    button_workload_t gen;
+    button_workload_edge_t edge;
+    button_replica_encoder_t enc;
+    button_replica_decoder_t dec;
+    check_channel_t ch;
+    uint8_t frame[CHECK_MAX_FRAME];
+    uint8_t current[CHECK_MAX_FRAME];
+    uint8_t previous[CHECK_MAX_FRAME];
+    size_t current_len = 0;
+    size_t previous_len = 0;
+    uint32_t frames = 0;
+    uint32_t stale = 0;
+    uint32_t events = 0;
+    uint32_t index = 0;
+
+    rng_state = seed | 1u;
+    check_link_t kind = (check_link_t)(seed % CHECK_LINK_MAX);
+    size_t cap = (check_rand() & 1u) ? CHECK_SMALL_FRAME : CHECK_MAX_FRAME;
+    uint32_t resync_at = CHECK_DURATION / 4u + check_rand() % (CHECK_DURATION / 4u);
+    uint32_t takeover = CHECK_DURATION / 2u + check_rand() % (CHECK_DURATION / 4u);
+    clock_offset = check_rand();
+    primary_tick = check_rand();
+    uint32_t start = primary_tick;
+
+    for (uint32_t i = 0; i < CHECK_BUTTONS; i++) {
+        entries[i] = (button_bank_entry_t){ .gpio_num = i, .active_level = BUTTON_ACTIVE_HIGH, .profile = (uint8_t)(i % 3u == 2u) };
+        levels[i] = false;
+    }
+
+    ButtonWorkload_DefaultConfig(&config, seed, CHECK_BUTTONS, CHECK_DURATION);
+    config.stages = check_stages;
+    config.stage_count = CHECK_STAGE_COUNT;
+    if (ButtonWorkload_Init(&gen, &config) != BUTTON_OK ||
+        Button_BankInit(&primary, entries, primary_states, CHECK_BUTTONS, check_profiles, 2, check_read_pin, check_primary_tick) != BUTTON_OK ||
+        Button_BankInit(&standby, entries, standby_states, CHECK_BUTTONS, check_profiles, 2, check_read_pin, check_standby_tick) != BUTTON_OK ||
+        Button_BankConfigDirty(&primary, dirty) != BUTTON_OK) {
+        printf("FAIL seed 0x%08lx: setup\n", (unsigned long)seed);
+        return false;
+    }
+#if BUTTON_FEATURE_DISPATCH
+    Button_BankRegisterHandler(&primary, check_record, &primary_log);
+    Button_BankRegisterHandler(&standby, check_record, &standby_log);
+#endif
+    ButtonReplica_EncoderInit(&enc);
+    ButtonReplica_DecoderInit(&dec);
+    if (!channel_open(&ch, kind)) {
+        printf("FAIL seed 0x%08lx: cannot open the link\n", (unsigned long)seed);
+        return false;
+    }
+
+    bool ok = true;
+    bool have_edge = ButtonWorkload_Next(&gen, &edge);
+    for (uint32_t t = 0; t < CHECK_DURATION && ok; t += CHECK_SCAN_TICKS) {
+        primary_tick = start + t;
+        while (have_edge && edge.tick <= t) {
+            levels[edge.index] = edge.pressed;
+            have_edge = ButtonWorkload_Next(&gen, &edge);
+        }
+
+        button_event_mask_t primary_mask, standby_mask;
+        uint32_t primary_count, standby_count;
+#if BUTTON_FEATURE_DISPATCH
+        primary_log.count = 0;
+        standby_log.count = 0;
+#endif
+        Button_BankUpdateEx(&primary, &primary_mask, &primary_count);
+
+        if (t >= takeover) {
+            /* The standby has taken over: same panel, same events, same state */
+            Button_BankUpdateEx(&standby, &standby_mask, &standby_count);
+            bool same = primary_mask == standby_mask && primary_count == standby_count;
+#if BUTTON_FEATURE_DISPATCH
+            same = same && primary_log.count == standby_log.count && primary_log.count <= CHECK_MAX_EVENTS;
+            for (uint32_t e = 0; same && e < primary_log.count; e++) {
+                same = primary_log.index[e] == standby_log.index[e] && primary_log.event[e] == standby_log.event[e];
+            }
+#endif
+            if (!same || !compare_banks(&index)) {
+                printf("FAIL seed 0x%08lx: tick +%lu after takeover, primary %lu events, standby %lu\n", (unsigned long)seed,
+                       (unsigned long)t, (unsigned long)primary_count, (unsigned long)standby_count);
+                ok = false;
+            }
+            events += primary_count;
+            continue;
+        }
+
+        if (t >= resync_at) {
+            ButtonReplica_Resync(&enc);
+            resync_at = UINT32_MAX;
+        }
+        do {
+            size_t len;
+            if (ButtonReplica_Encode(&enc, &primary, frame, cap, &len) != BUTTON_OK) {
+                printf("FAIL seed 0x%08lx: encode at tick +%lu\n", (unsigned long)seed, (unsigned long)t);
+                ok = false;
+                break;
+            }
+            if (len == 0) break;
+            if (!channel_send(&ch, frame, len) || !channel_receive(&ch, frame, &len) ||
+                ButtonReplica_Apply(&dec, &standby, frame, len) != BUTTON_OK) {
+                printf("FAIL seed 0x%08lx: frame %lu lost or rejected\n", (unsigned long)seed, (unsigned long)frames);
+                ok = false;
+                break;
+            }
+            frames++;
+            memcpy(previous, current, current_len);
+            previous_len = current_len;
+            memcpy(current, frame, len);
+            current_len = len;
+
+            /* A duplicate of this frame or a late copy of the one before must change nothing */
+            uint32_t roll = check_rand() % 8u;
+            const uint8_t *replay = (roll == 0) ? current : (roll == 1 && previous_len > 0) ? previous : NULL;
+            size_t replay_len = (roll == 0) ? current_len : previous_len;
+            if (replay && !(replay[3] & BUTTON_REPLICA_FLAG_SYNC)) {
+                uint32_t before = dec.stale_frames;
+                if (ButtonReplica_Apply(&dec, &standby, replay, replay_len) != BUTTON_OK || dec.stale_frames != before + 1u) {
+                    printf("FAIL seed 0x%08lx: replayed frame was not dropped\n", (unsigned long)seed);
+                    ok = false;
+                    break;
+                }
+                stale++;
+            }
+        } while (enc.pending);
+        if (!ok) break;
+
+        if (!dec.synced || dec.lost_frames != 0) {
+            printf("FAIL seed 0x%08lx: tick +%lu standby not in sync (lost %lu)\n", (unsigned long)seed,
+                   (unsigned long)t, (unsigned long)dec.lost_frames);
+            ok = false;
+        } else if (!compare_banks(&index)) {
+            printf("FAIL seed 0x%08lx: tick +%lu button %lu differs (state %u vs %u)\n", (unsigned long)seed,
+                   (unsigned long)t, (unsigned long)index, (unsigned)primary_states[index].state, (unsigned)standby_states[index].state);
+            ok = false;
+        }
+    }
+    channel_close(&ch);
+
+    if (ok) {
+        printf("ok   seed 0x%08lx %-5s cap %4lu: %lu frames, %lu stale dropped, %lu events after takeover\n",
+               (unsigned long)seed, kind == CHECK_LINK_PIPE ? "pipe" : "dgram", (unsigned long)cap,
+               (unsigned long)frames, (unsigned long)stale, (unsigned long)events);
+    }
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    uint32_t runs = 20;
+    uint32_t seed = 0x1234567u;
+    bool all_ok = true;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            runs = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            printf("usage: %s [-n runs] [-s seed]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    for (uint32_t r = 0; r < runs && all_ok; r++) {
+        all_ok = run_one(seed + r * 0x9E3779B9u);
+    }
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,36 @@
+#!/bin/sh
+# @file    button_size_report.sh
+# @author  datngyB
+# @brief   Code size of the button FSM per feature configuration.
+#
+# Compiles button_static.c and button_bank.c once per BUTTON_FEATURE_*
+# combination and prints text/data/bss of each object.
+#
+# Usage (from button_FSM/): tools/button_size_report.sh
+#   CC=arm-none-eabi-gcc SIZE=arm-none-eabi-size CFLAGS="-Os -mcpu=cortex-m0plus -mthumb" tools/button_size_report.sh
+
+CC=${CC:-cc}
+SIZE=${SIZE:-size}
+CFLAGS=${CFLAGS:--Os}
+OUT=$(mktemp -d) || exit 1
+trap 'rm -rf "$OUT"' EXIT
+
+report() {
+    name=$1
+    shift
+    for src in button_static button_bank; do
+        if ! $CC -std=c11 $CFLAGS -Iinclude "$@" -c "$src.c" -o "$OUT/$src.o"; then
+            echo "$name: $src.c failed to build" >&2
+            return 1
+        fi
+        $SIZE "$OUT/$src.o" | awk -v cfg="$name" -v obj="$src" 'NR == 2 { printf "%-18s %-14s %8s %8s %8s\n", cfg, obj, $1, $2, $3 }'
+    done
+}
+
+printf "%-18s %-14s %8s %8s %8s\n" "config" "object" "text" "data" "bss"
+report full
+report no-stages        -DBUTTON_FEATURE_STAGES=0
+report no-hold          -DBUTTON_FEATURE_HOLD=0
+report no-dispatch      -DBUTTON_FEATURE_DISPATCH=0
+report super-long-only  -DBUTTON_FEATURE_STAGES=0 -DBUTTON_FEATURE_SUPER_LONG=1
+report press-release    -DBUTTON_FEATURE_STAGES=0 -DBUTTON_FEATURE_HOLD=0 -DBUTTON_FEATURE_DISPATCH=0
@@ -0,0 +1,300 @@
+/**
+ * @file    button_stream_check.c
+ * @author  datngyB
+ * @brief   Socket path handling and frame delivery of button_stream.
+ * @version 0.1.0
+ * @date    2026-10-18
+ * * @copyright Copyright (c) 2026
+ *
+ * Each run uses its own socket path and checks, in order:
+ *   - stale path: a socket file left by a listener that is gone is replaced
+ *     by ButtonStream_Open;
+ *   - live path: a second Open on the path of a live publisher fails and the
+ *     live publisher keeps its clients; a regular file at the path is left
+ *     alone;
+ *   - early client: a client that connects before any event is accepted by
+ *     the quiet Flush calls that follow, and receives the first frame
+ *     (sequence 0);
+ *   - delivery: random sweeps of 0..CHECK_MAX_BATCH events (some above
+ *     BUTTON_STREAM_MAX_EVENTS) reach every client as one frame per non-empty
+ *     sweep, with the sweep tick, the events in order and the truncated flag
+ *     when events were dropped; quiet sweeps send nothing;
+ *   - Close removes the path.
+ *
+ * Usage: button_stream_check [-n runs] [-s seed]
+ * Build: cc -O2 -Iinclude linux/button_stream.c tools/button_stream_check.c
+ * Exit status is non-zero on the first mismatch.
+ */
+
+#define     _GNU_SOURCE
+#include    <stdbool.h>
+#include    <stdint.h>
+#include    <stdio.h>
+#include    <stdlib.h>
+#include    <string.h>
+#include    <errno.h>
+#include    <fcntl.h>
+#include    <poll.h>
+#include    <unistd.h>
+#include    <sys/socket.h>
+#include    <sys/stat.h>
+#include    <sys/un.h>
+#include    "button_stream.h"
+
+#define CHECK_CLIENTS               3u
+#define CHECK_SWEEPS                400u
+#define CHECK_MAX_BATCH             (BUTTON_STREAM_MAX_EVENTS + 16u)
+#define CHECK_QUIET_PERCENT         50u
+#define CHECK_QUIET_FLUSHES         3u
+
+static uint32_t rng_state;
+
+static uint32_t check_rand(void);
+static bool make_stale_socket(const char* path);
+static bool frame_pending(const button_stream_client_t* client);
+static bool stale_replaced(uint32_t seed, const char* path);
+static bool live_kept(uint32_t seed, const char* path, button_stream_pub_t* pub);
+static bool early_client_served(uint32_t seed, button_stream_pub_t* pub, button_stream_client_t* client);
+static bool frames_delivered(uint32_t seed, button_stream_pub_t* pub, button_stream_client_t* clients, uint32_t* frames);
+static bool run_one(uint32_t seed);
+
+
+static uint32_t check_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+/* A listener that was closed without unlinking its path: what a crashed publisher leaves */
+static bool make_stale_socket(const char* path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1u);
+
+    int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (fd < 0) return false;
+    bool ok = bind(fd, (const struct sockaddr*)&addr, sizeof(addr)) == 0 && listen(fd, 1) == 0;
+    close(fd);
+    return ok;
+}
+
+static bool frame_pending(const button_stream_client_t* client) {
+    struct pollfd pfd = { .fd = client->fd, .events = POLLIN };
+    return poll(&pfd, 1, 0) == 1;
+}
+
+static bool stale_replaced(uint32_t seed, const char* path) {
+    button_stream_pub_t pub;
+    struct stat st;
+
+    if (!make_stale_socket(path) || lstat(path, &st) != 0 || !S_ISSOCK(st.st_mode)) {
+        printf("FAIL seed 0x%08lx: could not leave a stale socket at %s\n", (unsigned long)seed, path);
+        return false;
+    }
+    if (ButtonStream_Open(&pub, path) != BUTTON_OK) {
+        printf("FAIL seed 0x%08lx: stale socket not replaced\n", (unsigned long)seed);
+        unlink(path);
+        return false;
+    }
+    ButtonStream_Close(&pub);
+    if (lstat(path, &st) == 0 || errno != ENOENT) {
+        printf("FAIL seed 0x%08lx: Close left the path behind\n", (unsigned long)seed);
+        return false;
+    }
+
+    /* Anything that is not a socket stays, and Open fails */
+    int fd = open(path, O_CREAT | O_EXCL | O_WRONLY | O_CLOEXEC, 0600);
+    if (fd < 0) return false;
+    close(fd);
+    bool refused = ButtonStream_Open(&pub, path) == BUTTON_ERR_HW_FAIL;
+    bool kept = lstat(path, &st) == 0 && S_ISREG(st.st_mode);
+    unlink(path);
+    if (!refused || !kept) {
+        printf("FAIL seed 0x%08lx: regular file at the path %s\n", (unsigned long)seed, refused ? "removed" : "not refused");
+        return false;
+    }
+    return true;
+}
+
+/* @p pub is live at @p path with one client; a second publisher must not take the path */
+static bool live_kept(uint32_t seed, const char* path, button_stream_pub_t* pub) {
+    button_stream_pub_t other;
+    button_stream_client_t late;
+
+    if (ButtonStream_Open(&other, path) != BUTTON_ERR_HW_FAIL) {
+        printf("FAIL seed 0x%08lx: second Open took a live path\n", (unsigned long)seed);
+        ButtonStream_Close(&other);
+        return false;
+    }
+    /* The probe connection of that Open sits in the backlog; the live publisher still accepts */
+    if (ButtonStream_Connect(&late, path) != BUTTON_OK) {
+        printf("FAIL seed 0x%08lx: live path no longer accepts\n", (unsigned long)seed);
+        return false;
+    }
+    ButtonStream_Flush(pub, 0);
+    bool ok = pub->client_count >= 2u;
+    ButtonStream_Disconnect(&late);
+    if (!ok) {
+        printf("FAIL seed 0x%08lx: live publisher lost its listener (%u clients)\n", (unsigned long)seed, (unsigned)pub->client_count);
+    }
+    return ok;
+}
+
+static bool early_client_served(uint32_t seed, button_stream_pub_t* pub, button_stream_client_t* client) {
+    button_stream_event_t events[4];
+    uint16_t count = 0;
+    uint32_t tick = 0;
+    uint8_t flags = 0;
+
+    for (uint32_t q = 0; q < CHECK_QUIET_FLUSHES; q++) {
+        ButtonStream_Flush(pub, q);
+    }
+    if (pub->client_count != 1u || frame_pending(client)) {
+        printf("FAIL seed 0x%08lx: early client %s after quiet flushes\n", (unsigned long)seed,
+               pub->client_count != 1u ? "not accepted" : "sent a frame");
+        return false;
+    }
+
+    ButtonStream_OnEvent(7, BUTTON_EVENT_PRESSED, pub);
+    ButtonStream_Flush(pub, 1000u);
+    if (ButtonStream_Receive(client, events, 4, &count, &tick, &flags) != BUTTON_OK || count != 1u || tick != 1000u ||
+        events[0].index != 7u || events[0].event != BUTTON_EVENT_PRESSED || client->last_sequence != 0u) {
+        printf("FAIL seed 0x%08lx: early client did not get the first frame\n", (unsigned long)seed);
+        return false;
+    }
+    return true;
+}
+
+static bool frames_delivered(uint32_t seed, button_stream_pub_t* pub, button_stream_client_t* clients, uint32_t* frames) {
+    static button_stream_event_t sent[CHECK_MAX_BATCH];
+    static button_stream_event_t got[BUTTON_STREAM_MAX_EVENTS];
+
+    *frames = 0;
+    for (uint32_t s = 0; s < CHECK_SWEEPS; s++) {
+        uint32_t tick = 2000u + s * 10u;
+        uint32_t n = 0;
+        if (check_rand() % 100u >= CHECK_QUIET_PERCENT) {
+            n = 1u + check_rand() % ((check_rand() % 8u == 0) ? CHECK_MAX_BATCH : 8u);
+        }
+        for (uint32_t e = 0; e < n; e++) {
+            sent[e].index = (uint16_t)(check_rand() % 512u);
+            sent[e].event = (button_event_t)(1u + check_rand() % (BUTTON_EVENT_MAX - 1u));
+            ButtonStream_OnEvent(sent[e].index, sent[e].event, pub);
+        }
+        ButtonStream_Flush(pub, tick);
+
+        uint16_t expected = (uint16_t)((n < BUTTON_STREAM_MAX_EVENTS) ? n : BUTTON_STREAM_MAX_EVENTS);
+        for (uint32_t c = 0; c < CHECK_CLIENTS; c++) {
+            uint16_t count = 0;
+            uint32_t at = 0;
+            uint8_t flags = 0;
+            if (n == 0) {
+                if (frame_pending(&clients[c])) {
+                    printf("FAIL seed 0x%08lx: quiet sweep %lu sent a frame\n", (unsigned long)seed, (unsigned long)s);
+                    return false;
+                }
+                continue;
+            }
+            if (ButtonStream_Receive(&clients[c], got, BUTTON_STREAM_MAX_EVENTS, &count, &at, &flags) != BUTTON_OK ||
+                count != expected || at != tick ||
+                ((flags & BUTTON_STREAM_FLAG_TRUNCATED) != 0) != (n > BUTTON_STREAM_MAX_EVENTS)) {
+                printf("FAIL seed 0x%08lx: sweep %lu client %lu got %u events at %lu flags 0x%02x, sent %lu at %lu\n",
+                       (unsigned long)seed, (unsigned long)s, (unsigned long)c, (unsigned)count, (unsigned long)at,
+                       (unsigned)flags, (unsigned long)n, (unsigned long)tick);
+                return false;
+            }
+            for (uint16_t e = 0; e < count; e++) {
+                if (got[e].index != sent[e].index || got[e].event != sent[e].event) {
+                    printf("FAIL seed 0x%08lx: sweep %lu client %lu event %u differs\n", (unsigned long)seed,
+                           (unsigned long)s, (unsigned long)c, (unsigned)e);
+                    return false;
+                }
+            }
+        }
+        if (n > 0) (*frames)++;
+    }
+
+    for (uint32_t c = 0; c < CHECK_CLIENTS; c++) {
+        if (clients[c].lost_frames != 0) {
+            printf("FAIL seed 0x%08lx: client %lu saw %lu lost frames\n", (unsigned long)seed, (unsigned long)c,
+                   (unsigned long)clients[c].lost_frames);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool run_one(uint32_t seed) {
+    char path[BUTTON_STREAM_PATH_MAX];
+    button_stream_pub_t pub;
+    button_stream_client_t clients[CHECK_CLIENTS];
+    uint32_t frames = 0;
+    bool ok;
+
+    rng_state = seed | 1u;
+    snprintf(path, sizeof(path), "/tmp/button_stream_check.%ld.%08lx", (long)getpid(), (unsigned long)seed);
+    unlink(path);
+
+    if (!stale_replaced(seed, path)) return false;
+    if (!make_stale_socket(path) || ButtonStream_Open(&pub, path) != BUTTON_OK) {
+        printf("FAIL seed 0x%08lx: open\n", (unsigned long)seed);
+        unlink(path);
+        return false;
+    }
+
+    ok = ButtonStream_Connect(&clients[0], path) == BUTTON_OK && early_client_served(seed, &pub, &clients[0]);
+    ok = ok && live_kept(seed, path, &pub);
+    for (uint32_t c = 1; ok && c < CHECK_CLIENTS; c++) {
+        ok = ButtonStream_Connect(&clients[c], path) == BUTTON_OK;
+    }
+    if (ok) {
+        /* The late clients join at the next flush and take frames from there on */
+        ButtonStream_Flush(&pub, 1500u);
+        for (uint32_t c = 1; c < CHECK_CLIENTS; c++) {
+            clients[c].has_sequence = true;
+            clients[c].last_sequence = pub.sequence - 1u;
+        }
+        ok = frames_delivered(seed, &pub, clients, &frames);
+    }
+
+    for (uint32_t c = 0; c < CHECK_CLIENTS; c++) {
+        ButtonStream_Disconnect(&clients[c]);
+    }
+    ButtonStream_Close(&pub);
+    struct stat st;
+    if (ok && lstat(path, &st) == 0) {
+        printf("FAIL seed 0x%08lx: Close left the path behind\n", (unsigned long)seed);
+        ok = false;
+    }
+    unlink(path);
+
+    if (ok) {
+        printf("ok   seed 0x%08lx: %lu frames to %u clients, %lu dropped\n", (unsigned long)seed, (unsigned long)frames,
+               (unsigned)CHECK_CLIENTS, (unsigned long)pub.dropped_frames);
+    }
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    uint32_t runs = 8;
+    uint32_t seed = 0x1234567u;
+    bool all_ok = true;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            runs = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            printf("usage: %s [-n runs] [-s seed]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    for (uint32_t r = 0; r < runs && all_ok; r++) {
+        all_ok = run_one(seed + r * 0x9E3779B9u);
+    }
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,262 @@
+/**
+ * @file    button_ticks_check.c
+ * @author  datngyB
+ * @brief   Millisecond to tick conversion, alone and through Button_BankProfilesFromMs.
+ * @version 0.1.0
+ * @date    2026-10-18
+ * * @copyright Copyright (c) 2026
+ *
+ * Each run checks:
+ *   - BUTTON_MS_TO_TICKS at 1000 Hz is the identity, and at 32768 Hz it is
+ *     the smallest tick count that lasts at least the time asked for: fixed
+ *     values (1 ms is 33 ticks, 50 ms is 1639, 125 ms is exactly 4096) and
+ *     random ones up to the largest that fits 32 bits;
+ *   - Button_BankProfilesFromMs at both rates: every timing converted with the
+ *     macro, stage tables laid out back to back in the caller buffer, HOLD
+ *     intervals 0 and BUTTON_HOLD_OFF passed through unchanged, and the
+ *     profiles accepted by Button_BankInit. Without stages, a profile with a
+ *     stage table is refused;
+ *   - the refusals: no tick rate, a stage buffer one stage short, and two
+ *     stage thresholds that round to the same tick at a coarse 10 Hz.
+ *
+ * Usage: button_ticks_check [-n runs] [-s seed]
+ * Build: cc -O2 -Iinclude button_static.c button_bank.c button_latency.c tools/button_ticks_check.c
+ * Exit status is non-zero on the first mismatch.
+ */
+
+#include    <stdbool.h>
+#include    <stdint.h>
+#include    <stdio.h>
+#include    <stdlib.h>
+#include    <string.h>
+#include    "button_bank.h"
+
+#define CHECK_RANDOM_VALUES         100000u
+#define CHECK_MAX_MS_32K            131071999u  /* Largest millisecond count whose 32768 Hz tick count fits 32 bits */
+#define CHECK_PROFILES              3u
+#define CHECK_STAGES_PER_PROFILE    3u
+#define CHECK_BUTTONS               4u
+
+typedef struct {
+    uint32_t ms;
+    uint32_t ticks;
+} check_pair_t;
+
+static const check_pair_t fixed_32k[] = {
+    { 0u, 0u }, { 1u, 33u }, { 50u, 1639u }, { 125u, 4096u }, { 1000u, 32768u }, { 1001u, 32801u },
+    { CHECK_MAX_MS_32K, 0xFFFFFFE0u },
+};
+
+static button_stage_config_t stage_ms[CHECK_PROFILES][CHECK_STAGES_PER_PROFILE];
+static button_profile_ms_t ms_profiles[CHECK_PROFILES];
+static button_profile_t profiles[CHECK_PROFILES];
+static button_stage_config_t stage_buf[CHECK_PROFILES * CHECK_STAGES_PER_PROFILE];
+static uint32_t rng_state;
+
+static uint32_t check_rand(void);
+static bool check_read_pin(uint32_t gpio_num);
+static uint32_t check_get_tick(void);
+static bool rounds_up(uint32_t ms, uint32_t tick_hz, uint32_t ticks);
+static bool macro_rounds(uint32_t seed);
+static void random_profiles(void);
+static bool profiles_converted(uint32_t seed, uint32_t tick_hz);
+static bool refusals(uint32_t seed);
+static bool run_one(uint32_t seed);
+
+
+static uint32_t check_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static bool check_read_pin(uint32_t gpio_num) {
+    (void)gpio_num;
+    return false;
+}
+
+static uint32_t check_get_tick(void) {
+    return 0;
+}
+
+/* ticks lasts at least ms, and one tick less would not */
+static bool rounds_up(uint32_t ms, uint32_t tick_hz, uint32_t ticks) {
+    uint64_t wanted = (uint64_t)ms * tick_hz;
+    uint64_t lasts = (uint64_t)ticks * 1000u;
+    return lasts >= wanted && (ticks == 0 || lasts - 1000u < wanted);
+}
+
+static bool macro_rounds(uint32_t seed) {
+    for (size_t i = 0; i < sizeof(fixed_32k) / sizeof(fixed_32k[0]); i++) {
+        uint32_t ticks = BUTTON_MS_TO_TICKS(fixed_32k[i].ms, 32768u);
+        if (ticks != fixed_32k[i].ticks) {
+            printf("FAIL seed 0x%08lx: %lu ms is %lu ticks at 32768 Hz, expected %lu\n", (unsigned long)seed,
+                   (unsigned long)fixed_32k[i].ms, (unsigned long)ticks, (unsigned long)fixed_32k[i].ticks);
+            return false;
+        }
+    }
+    for (uint32_t n = 0; n < CHECK_RANDOM_VALUES; n++) {
+        uint32_t ms = check_rand();
+        uint32_t ms_32k = ms % (CHECK_MAX_MS_32K + 1u);
+        uint32_t ticks_1k = BUTTON_MS_TO_TICKS(ms, 1000u);
+        uint32_t ticks_32k = BUTTON_MS_TO_TICKS(ms_32k, 32768u);
+        if (ticks_1k != ms || !rounds_up(ms_32k, 32768u, ticks_32k)) {
+            printf("FAIL seed 0x%08lx: %lu ms is %lu ticks at 1000 Hz, %lu ms is %lu ticks at 32768 Hz\n",
+                   (unsigned long)seed, (unsigned long)ms, (unsigned long)ticks_1k, (unsigned long)ms_32k,
+                   (unsigned long)ticks_32k);
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Increasing thresholds and a mix of HOLD intervals; profile 0 has no stages */
+static void random_profiles(void) {
+    for (uint8_t p = 0; p < CHECK_PROFILES; p++) {
+        uint32_t threshold = 0;
+        uint8_t count = (p == 0) ? 0 : (uint8_t)(1u + check_rand() % CHECK_STAGES_PER_PROFILE);
+        for (uint8_t s = 0; s < count; s++) {
+            static const uint32_t holds[] = { 0u, BUTTON_HOLD_OFF, 1u, 20u, 333u };
+            threshold += 1u + check_rand() % 3000u;
+            stage_ms[p][s] = (button_stage_config_t){
+                .threshold = threshold,
+                .event = (button_event_t)(BUTTON_EVENT_PRESSED + check_rand() % (BUTTON_EVENT_MAX - 1u)),
+                .hold_ticks = holds[check_rand() % (sizeof(holds) / sizeof(holds[0]))],
+            };
+        }
+        ms_profiles[p] = (button_profile_ms_t){
+            .debounce_ms = check_rand() % 200u,
+            .long_press_ms = 1u + check_rand() % 5000u,
+            .hold_ms = 1u + check_rand() % 500u,
+            .stages = (count > 0) ? stage_ms[p] : NULL,
+            .stage_count = count,
+        };
+    }
+}
+
+static bool profiles_converted(uint32_t seed, uint32_t tick_hz) {
+    button_bank_entry_t entries[CHECK_BUTTONS] = { { 0 } };
+    button_bank_state_t states[CHECK_BUTTONS];
+    button_bank_t bank;
+
+    random_profiles();
+    button_error_t err = Button_BankProfilesFromMs(profiles, stage_buf, CHECK_PROFILES * CHECK_STAGES_PER_PROFILE,
+                                                   ms_profiles, CHECK_PROFILES, tick_hz);
+#if !BUTTON_FEATURE_STAGES
+    /* Stage tables need the feature; a profile without one converts alone */
+    if (err != BUTTON_ERR_INVALID_STAGES ||
+        Button_BankProfilesFromMs(profiles, NULL, 0, ms_profiles, 1, tick_hz) != BUTTON_OK) {
+        printf("FAIL seed 0x%08lx: %lu Hz, stage tables accepted without stages, or a plain profile refused\n",
+               (unsigned long)seed, (unsigned long)tick_hz);
+        return false;
+    }
+    uint8_t converted = 1;
+#else
+    if (err != BUTTON_OK) {
+        printf("FAIL seed 0x%08lx: %lu Hz, conversion refused (%d)\n", (unsigned long)seed, (unsigned long)tick_hz, (int)err);
+        return false;
+    }
+    uint8_t converted = CHECK_PROFILES;
+#endif
+
+    const button_stage_config_t *next = stage_buf;
+    for (uint8_t p = 0; p < converted; p++) {
+        const button_profile_ms_t *ms = &ms_profiles[p];
+        const button_profile_t *pr = &profiles[p];
+        bool ok = pr->debounce_ticks == BUTTON_MS_TO_TICKS(ms->debounce_ms, tick_hz) &&
+                  pr->long_press_ticks == BUTTON_MS_TO_TICKS(ms->long_press_ms, tick_hz) &&
+                  pr->hold_ticks == BUTTON_MS_TO_TICKS(ms->hold_ms, tick_hz) &&
+                  pr->stage_count == ms->stage_count &&
+                  pr->stages == ((ms->stage_count > 0) ? next : NULL);
+        for (uint8_t s = 0; ok && s < pr->stage_count; s++) {
+            uint32_t hold = ms->stages[s].hold_ticks;
+            uint32_t hold_ticks = (hold == 0 || hold == BUTTON_HOLD_OFF) ? hold : BUTTON_MS_TO_TICKS(hold, tick_hz);
+            ok = pr->stages[s].threshold == BUTTON_MS_TO_TICKS(ms->stages[s].threshold, tick_hz) &&
+                 pr->stages[s].event == ms->stages[s].event && pr->stages[s].hold_ticks == hold_ticks;
+        }
+        if (!ok) {
+            printf("FAIL seed 0x%08lx: %lu Hz, profile %u converted to %lu/%lu/%lu ticks with %u stages\n",
+                   (unsigned long)seed, (unsigned long)tick_hz, (unsigned)p, (unsigned long)pr->debounce_ticks,
+                   (unsigned long)pr->long_press_ticks, (unsigned long)pr->hold_ticks, (unsigned)pr->stage_count);
+            return false;
+        }
+        next += pr->stage_count;
+    }
+
+    for (uint16_t i = 0; i < CHECK_BUTTONS; i++) {
+        entries[i].gpio_num = i;
+        entries[i].active_level = BUTTON_ACTIVE_HIGH;
+        entries[i].profile = (uint8_t)(i % converted);
+    }
+    if (Button_BankInit(&bank, entries, states, CHECK_BUTTONS, profiles, converted, check_read_pin, check_get_tick) != BUTTON_OK) {
+        printf("FAIL seed 0x%08lx: %lu Hz, converted profiles refused by the bank\n", (unsigned long)seed,
+               (unsigned long)tick_hz);
+        return false;
+    }
+    return true;
+}
+
+static bool refusals(uint32_t seed) {
+    static const button_stage_config_t close_ms[] = {
+        { 1010u, BUTTON_EVENT_SUPER_LONG_PRESSED, 0 },
+        { 1050u, BUTTON_EVENT_HOLD, 0 },    /* Both 11 ticks at 10 Hz */
+    };
+    const button_profile_ms_t close_profile = { 20u, 1000u, 50u, close_ms, 2u };
+
+    random_profiles();
+    button_error_t no_rate = Button_BankProfilesFromMs(profiles, stage_buf, CHECK_PROFILES * CHECK_STAGES_PER_PROFILE,
+                                                       ms_profiles, CHECK_PROFILES, 0);
+    const button_profile_ms_t *staged = &ms_profiles[CHECK_PROFILES - 1u];
+    button_error_t short_buf = Button_BankProfilesFromMs(profiles, stage_buf, (uint16_t)(staged->stage_count - 1u),
+                                                         staged, 1, 1000u);
+    button_error_t merged = Button_BankProfilesFromMs(profiles, stage_buf, 2u, &close_profile, 1, 10u);
+    button_error_t kept = Button_BankProfilesFromMs(profiles, stage_buf, 2u, &close_profile, 1, 1000u);
+
+#if BUTTON_FEATURE_STAGES
+    button_error_t kept_expected = BUTTON_OK;
+#else
+    button_error_t kept_expected = BUTTON_ERR_INVALID_STAGES;
+#endif
+    if (no_rate != BUTTON_ERR_INVALID_ARG || short_buf != BUTTON_ERR_INVALID_ARG ||
+        merged != BUTTON_ERR_INVALID_STAGES || kept != kept_expected) {
+        printf("FAIL seed 0x%08lx: no tick rate %d, short stage buffer %d, merged thresholds %d, distinct thresholds %d\n",
+               (unsigned long)seed, (int)no_rate, (int)short_buf, (int)merged, (int)kept);
+        return false;
+    }
+    return true;
+}
+
+static bool run_one(uint32_t seed) {
+    rng_state = seed | 1u;
+    if (!macro_rounds(seed)) return false;
+    if (!profiles_converted(seed, 1000u)) return false;
+    if (!profiles_converted(seed, 32768u)) return false;
+    if (!refusals(seed)) return false;
+
+    printf("ok   seed 0x%08lx: %lu values rounded at 1000 and 32768 Hz, profiles converted at both\n",
+           (unsigned long)seed, (unsigned long)CHECK_RANDOM_VALUES);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    uint32_t runs = 4;
+    uint32_t seed = 0x1234567u;
+    bool all_ok = true;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            runs = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            printf("usage: %s [-n runs] [-s seed]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    for (uint32_t r = 0; r < runs && all_ok; r++) {
+        all_ok = run_one(seed + r * 0x9E3779B9u);
+    }
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,212 @@
+#include    <stdbool.h>
+#include    <stdint.h>
+#include    <stddef.h>
+#include    <math.h>
+#include    "button_workload.h"
+
+static uint32_t rng_next(uint32_t* state);
+static uint32_t rng_range(uint32_t* state, uint32_t lo, uint32_t hi);
+static uint32_t rng_exponential(uint32_t* state, uint32_t mean);
+static uint16_t pick_button(button_workload_t* gen);
+static uint32_t press_length(button_workload_t* gen);
+static void start_arrival(button_workload_t* gen);
+static void emit_edge(button_workload_t* gen, uint16_t i, button_workload_edge_t* edge);
+
+/* Mostly taps, with a share of presses straddling debounce, long press and the stages */
+static const button_workload_press_t default_presses[] = {
+    { 55, BUTTON_WORKLOAD_ANCHOR_DEBOUNCE,   1,  BUTTON_LONG_PRESS_TICKS / 2 },
+    {  5, BUTTON_WORKLOAD_ANCHOR_DEBOUNCE,   -3, 3 },
+    { 15, BUTTON_WORKLOAD_ANCHOR_LONG_PRESS, -3, 3 },
+    { 15, BUTTON_WORKLOAD_ANCHOR_LONG_PRESS, 1,  5 * BUTTON_HOLD_TICKS },
+    { 10, BUTTON_WORKLOAD_ANCHOR_STAGE,      -3, 3 },
+};
+
+
+/* Default models for the compile-time FSM timings; adjust fields before ButtonWorkload_Init */
+button_error_t ButtonWorkload_DefaultConfig(button_workload_config_t* config, uint32_t seed, uint16_t button_count, uint32_t duration) {
+    if (!config) return BUTTON_ERR_INVALID_ARG;
+
+    *config = (button_workload_config_t){
+        .seed = seed,
+        .button_count = button_count,
+        .duration = duration,
+        .mean_gap_ticks = 500,
+        .skew_percent = 100,
+        .presses = default_presses,
+        .press_count = (uint8_t)(sizeof(default_presses) / sizeof(default_presses[0])),
+        .debounce_ticks = BUTTON_DEBOUNCE_TICKS,
+        .long_press_ticks = BUTTON_LONG_PRESS_TICKS,
+        .stages = NULL,
+        .stage_count = 0,
+        .max_bounces = 4,
+        .max_bounce_ticks = 3,
+        .glitch_percent = 5,
+        .max_glitch_ticks = 3,
+    };
+    return BUTTON_OK;
+}
+
+button_error_t ButtonWorkload_Init(button_workload_t* gen, const button_workload_config_t* config) {
+    if (!gen || !config) return BUTTON_ERR_INVALID_ARG;
+    if (config->button_count == 0 || config->button_count > BUTTON_WORKLOAD_MAX_BUTTONS) return BUTTON_ERR_INVALID_ARG;
+    if (config->mean_gap_ticks == 0 || !config->presses || config->press_count == 0) return BUTTON_ERR_INVALID_ARG;
+    if (config->max_bounces > BUTTON_WORKLOAD_MAX_BOUNCES || (config->max_bounces > 0 && config->max_bounce_ticks == 0)) return BUTTON_ERR_INVALID_ARG;
+    if (config->glitch_percent > 100 || (config->glitch_percent > 0 && config->max_glitch_ticks == 0)) return BUTTON_ERR_INVALID_ARG;
+    if (config->stage_count > 0 && !config->stages) return BUTTON_ERR_INVALID_STAGES;
+
+    uint32_t total = 0;
+    for (uint8_t c = 0; c < config->press_count; c++) {
+        if (config->presses[c].min_offset > config->presses[c].max_offset) return BUTTON_ERR_INVALID_ARG;
+        total += config->presses[c].weight;
+    }
+    if (total == 0) return BUTTON_ERR_INVALID_ARG;
+
+    gen->config = *config;
+    gen->rng = config->seed ? config->seed : 1u;
+    gen->press_weight = total;
+    gen->dropped = 0;
+
+    double exponent = (double)config->skew_percent / 100.0;
+    double sum = 0.0;
+    for (uint16_t i = 0; i < config->button_count; i++) sum += pow((double)(i + 1u), -exponent);
+    double acc = 0.0;
+    for (uint16_t i = 0; i < config->button_count; i++) {
+        acc += pow((double)(i + 1u), -exponent);
+        gen->cdf[i] = (uint32_t)(acc / sum * 16777216.0);
+        gen->lanes[i] = (button_workload_lane_t){ .next_tick = 0, .edges_left = 0 };
+    }
+    gen->cdf[config->button_count - 1u] = 16777216u;    /* Rounding never leaves a gap at the top */
+
+    gen->next_arrival = rng_exponential(&gen->rng, config->mean_gap_ticks);
+    return BUTTON_OK;
+}
+
+/*
+ * Next level change, in tick order; edges of different buttons on the same
+ * tick come out by ascending index. A button released on tick t is not
+ * pressed again before t + 1.
+ */
+bool ButtonWorkload_Next(button_workload_t* gen, button_workload_edge_t* edge) {
+    if (!gen || !edge) return false;
+
+    for (;;) {
+        uint64_t next = UINT64_MAX;
+        uint16_t lane = 0;
+        for (uint16_t i = 0; i < gen->config.button_count; i++) {
+            if (gen->lanes[i].edges_left > 0 && gen->lanes[i].next_tick < next) {
+                next = gen->lanes[i].next_tick;
+                lane = i;
+            }
+        }
+
+        if (gen->next_arrival <= next) {
+            if (gen->next_arrival >= gen->config.duration) return false;
+            start_arrival(gen);
+            continue;
+        }
+        if (next >= gen->config.duration) return false;
+        emit_edge(gen, lane, edge);
+        return true;
+    }
+}
+
+/* xorshift32: the same sequence on every host */
+static uint32_t rng_next(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static uint32_t rng_range(uint32_t* state, uint32_t lo, uint32_t hi) {
+    return lo + (rng_next(state) % (hi - lo + 1u));
+}
+
+static uint32_t rng_exponential(uint32_t* state, uint32_t mean) {
+    double u = ((double)(rng_next(state) & 0xFFFFFFu) + 1.0) / 16777217.0;
+    return (uint32_t)(-log(u) * (double)mean) + 1u;
+}
+
+static uint16_t pick_button(button_workload_t* gen) {
+    uint32_t r = rng_next(&gen->rng) & 0xFFFFFFu;
+    uint16_t i = 0;
+    while (i + 1u < gen->config.button_count && gen->cdf[i] <= r) i++;
+    return i;
+}
+
+static uint32_t press_length(button_workload_t* gen) {
+    const button_workload_config_t *cfg = &gen->config;
+    uint32_t r = rng_next(&gen->rng) % gen->press_weight;
+    const button_workload_press_t *cls = cfg->presses;
+    while (r >= cls->weight) {
+        r -= cls->weight;
+        cls++;
+    }
+
+    int64_t base = 0;
+    switch (cls->anchor) {
+        case BUTTON_WORKLOAD_ANCHOR_DEBOUNCE:
+            base = cfg->debounce_ticks;
+            break;
+        case BUTTON_WORKLOAD_ANCHOR_STAGE:
+            /* Without stages, the class straddles the long press */
+            if (cfg->stage_count > 0) base = cfg->stages[rng_range(&gen->rng, 0, cfg->stage_count - 1u)].threshold;
+            base += (int64_t)cfg->debounce_ticks + cfg->long_press_ticks;
+            break;
+        case BUTTON_WORKLOAD_ANCHOR_LONG_PRESS:
+            base = (int64_t)cfg->debounce_ticks + cfg->long_press_ticks;
+            break;
+        case BUTTON_WORKLOAD_ANCHOR_NONE:
+        default:
+            break;
+    }
+    int64_t len = base + cls->min_offset + (int64_t)rng_range(&gen->rng, 0, (uint32_t)(cls->max_offset - cls->min_offset));
+    if (len < 1) len = 1;
+    if (len > UINT32_MAX) len = UINT32_MAX;
+    return (uint32_t)len;
+}
+
+/* Arrivals for a button that is still pressed or bouncing are dropped */
+static void start_arrival(button_workload_t* gen) {
+    const button_workload_config_t *cfg = &gen->config;
+    uint16_t i = pick_button(gen);
+    button_workload_lane_t *l = &gen->lanes[i];
+    bool glitch = rng_range(&gen->rng, 0, 99) < cfg->glitch_percent;
+
+    if (l->edges_left > 0) {
+        gen->dropped++;
+    } else {
+        l->next_tick = gen->next_arrival;
+        l->level = true;
+        l->releasing = false;
+        l->glitch = glitch;
+        if (glitch) {
+            l->edges_left = 1;
+            l->hold_ticks = rng_range(&gen->rng, 1, cfg->max_glitch_ticks);
+        } else {
+            l->edges_left = (uint8_t)(1u + 2u * rng_range(&gen->rng, 0, cfg->max_bounces));
+            l->hold_ticks = press_length(gen);
+        }
+    }
+    gen->next_arrival += rng_exponential(&gen->rng, cfg->mean_gap_ticks);
+}
+
+/* A burst is the settled level preceded by bounce glitches: 2k + 1 alternating edges */
+static void emit_edge(button_workload_t* gen, uint16_t i, button_workload_edge_t* edge) {
+    const button_workload_config_t *cfg = &gen->config;
+    button_workload_lane_t *l = &gen->lanes[i];
+
+    *edge = (button_workload_edge_t){ .tick = (uint32_t)l->next_tick, .index = i, .pressed = l->level };
+    l->edges_left--;
+    l->level = !l->level;
+
+    if (l->edges_left > 0) {
+        l->next_tick += rng_range(&gen->rng, 1, cfg->max_bounce_ticks);
+    } else if (!l->releasing) {
+        l->releasing = true;
+        l->next_tick += l->hold_ticks;
+        l->edges_left = l->glitch ? 1u : (uint8_t)(1u + 2u * rng_range(&gen->rng, 0, cfg->max_bounces));
+    }
+}
@@ -0,0 +1,103 @@
+/**
+ * @file    button_workload.h
+ * @author  datngyB
+ * @brief   Reproducible press workloads shared by the benchmarks and the oracle.
+ * @version 0.1.0
+ * @date    2026-10-18
+ * * @copyright Copyright (c) 2026
+ *
+ * Generates the logical level changes of a panel from a few models:
+ *   - arrivals : presses arrive as one Poisson process for the whole panel
+ *                and are spread over the buttons with a Zipf-like skew, so a
+ *                few buttons take most of the traffic;
+ *   - presses  : lengths are drawn from weighted classes, absolute or
+ *                anchored on the debounce, long-press or stage thresholds so
+ *                that a share of presses lands just before and just after them;
+ *   - bounce   : every settled edge is preceded by a burst of short glitches;
+ *   - glitches : a share of arrivals are isolated spikes (EMI, a brushed key)
+ *                instead of presses.
+ *
+ * Edges come out one at a time in tick order, so callers fill their own trace
+ * format and the trace length is not bounded by a buffer here. The sequence
+ * depends only on the configuration and the seed.
+ */
+
+#ifndef BUTTON_WORKLOAD_H
+#define BUTTON_WORKLOAD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "button_static.h"
+
+#define BUTTON_WORKLOAD_MAX_BUTTONS 64
+#define BUTTON_WORKLOAD_MAX_BOUNCES 8   /* Glitches per bounce burst */
+
+/* What a press class length is measured from */
+typedef enum {
+    BUTTON_WORKLOAD_ANCHOR_NONE = 0,    /* Absolute length */
+    BUTTON_WORKLOAD_ANCHOR_DEBOUNCE,    /* debounce_ticks + offset */
+    BUTTON_WORKLOAD_ANCHOR_LONG_PRESS,  /* debounce_ticks + long_press_ticks + offset */
+    BUTTON_WORKLOAD_ANCHOR_STAGE,       /* As LONG_PRESS, plus the threshold of a random stage */
+} button_workload_anchor_t;
+
+/* One class of press lengths (Flash) */
+typedef struct {
+    uint32_t weight;                    /**< Relative frequency among the classes */
+    button_workload_anchor_t anchor;
+    int32_t min_offset;                 /**< Length drawn uniformly in [anchor + min, anchor + max], at least 1 tick */
+    int32_t max_offset;
+} button_workload_press_t;
+
+typedef struct {
+    uint32_t seed;
+    uint16_t button_count;
+    uint32_t duration;                  /**< No edge at or after this tick */
+    uint32_t mean_gap_ticks;            /**< Mean time between arrivals over the whole panel */
+    uint8_t skew_percent;               /**< Zipf exponent in percent: 0 uniform, 100 button i gets 1/(i+1) of the weight */
+
+    const button_workload_press_t *presses;
+    uint8_t press_count;
+    uint32_t debounce_ticks;            /**< Anchors; usually the FSM timings under test */
+    uint32_t long_press_ticks;
+    const button_stage_config_t *stages;    /**< Optional, for BUTTON_WORKLOAD_ANCHOR_STAGE */
+    uint8_t stage_count;
+
+    uint8_t max_bounces;                /**< Glitches per edge, drawn in [0, max_bounces] */
+    uint32_t max_bounce_ticks;          /**< Length of each bounce glitch, drawn in [1, max] */
+    uint8_t glitch_percent;             /**< Share of arrivals that are an isolated spike */
+    uint32_t max_glitch_ticks;          /**< Spike length, drawn in [1, max] */
+} button_workload_config_t;
+
+/* One logical level change */
+typedef struct {
+    uint32_t tick;
+    uint16_t index;
+    bool pressed;
+} button_workload_edge_t;
+
+/* Per-button generator state */
+typedef struct {
+    uint64_t next_tick;     /**< Tick of the next edge, valid while edges_left > 0 */
+    uint32_t hold_ticks;    /**< Settled press length, applied when the press burst ends */
+    uint8_t edges_left;     /**< Edges left in the current burst; 0 when the button is idle */
+    bool level;             /**< Level of the next edge */
+    bool releasing;         /**< The current burst is the release */
+    bool glitch;            /**< The current press is a spike: released without bounce */
+} button_workload_lane_t;
+
+typedef struct {
+    button_workload_config_t config;
+    uint32_t rng;
+    uint64_t next_arrival;
+    uint32_t press_weight;                          /**< Sum of the class weights */
+    uint32_t cdf[BUTTON_WORKLOAD_MAX_BUTTONS];      /**< Cumulative skew weights, scaled to 2^24 */
+    button_workload_lane_t lanes[BUTTON_WORKLOAD_MAX_BUTTONS];
+    uint32_t dropped;                               /**< Arrivals for a button that was still busy */
+} button_workload_t;
+
+// API
+button_error_t ButtonWorkload_DefaultConfig(button_workload_config_t* config, uint32_t seed, uint16_t button_count, uint32_t duration);
+button_error_t ButtonWorkload_Init(button_workload_t* gen, const button_workload_config_t* config);
+bool ButtonWorkload_Next(button_workload_t* gen, button_workload_edge_t* edge);    // false once the duration is reached
+
+#endif // BUTTON_WORKLOAD_H